@@ -0,0 +1,207 @@
+//
+//  SignalBenchmarks.cpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#include "Threads/CoalescingSignal.hpp"
+#include "Threads/Signal.hpp"
+#include "Threads/Thread.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// @brief cost of emitting a signal to listeners on the emitting thread (called directly)
+static void BM_SignalEmitSameThread(benchmark::State& state)
+{
+    // A thread that hasn't been started is the current thread
+    gusc::Threads::Thread thread;
+    gusc::Threads::Signal<int> signal;
+    std::int64_t sum { 0 };
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        signal.connect(&thread, [&sum](const int& value){
+            sum += value;
+        });
+    }
+    for (auto _ : state)
+    {
+        signal.emit(1);
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignalEmitSameThread)->ArgName("slots")->Arg(1)->Arg(10)->Arg(100);
+
+namespace
+{
+std::int64_t directSum { 0 };
+
+void directListener(const int& value)
+{
+    directSum += value;
+}
+}
+
+/// @brief cost of emitting a signal to plain function listeners connected as direct (no thread check and no std::function)
+static void BM_SignalEmitDirect(benchmark::State& state)
+{
+    gusc::Threads::Thread threads[100];
+    gusc::Threads::Signal<int> signal;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        // Same function on different threads makes distinct connections
+        signal.connect(&threads[i], &directListener, gusc::Threads::ConnectionType::Direct);
+    }
+    for (auto _ : state)
+    {
+        signal.emit(1);
+    }
+    benchmark::DoNotOptimize(directSum);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignalEmitDirect)->ArgName("slots")->Arg(1)->Arg(10)->Arg(100);
+
+namespace
+{
+class ListenerThread : public gusc::Threads::Thread
+{
+public:
+    void listen(const int& value)
+    {
+        sum += value;
+    }
+    std::int64_t sum { 0 };
+};
+}
+
+/// @brief cost of emitting a signal to direct member method listeners connected with a runtime member pointer or with connect<Method>()
+static void BM_SignalEmitMethod(benchmark::State& state)
+{
+    ListenerThread threads[100];
+    gusc::Threads::Signal<int> signal;
+    for (std::int64_t i = 0; i < state.range(1); ++i)
+    {
+        if (state.range(0))
+        {
+            signal.connect<&ListenerThread::listen>(&threads[i], gusc::Threads::ConnectionType::Direct);
+        }
+        else
+        {
+            signal.connect(&threads[i], &ListenerThread::listen, gusc::Threads::ConnectionType::Direct);
+        }
+    }
+    for (auto _ : state)
+    {
+        signal.emit(1);
+    }
+    benchmark::DoNotOptimize(threads[0].sum);
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_SignalEmitMethod)->ArgNames({"typed", "slots"})->ArgsProduct({{0, 1}, {1, 10, 100}});
+
+/// @brief cost of emitting a signal to listeners on another thread, measured until all the listeners have been called
+static void BM_SignalEmitCrossThread(benchmark::State& state)
+{
+    gusc::Threads::Thread thread;
+    thread.start();
+    gusc::Threads::Signal<int> signal;
+    std::atomic<std::int64_t> sum { 0 };
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        signal.connect(&thread, [&sum](const int& value){
+            sum.fetch_add(value, std::memory_order_relaxed);
+        });
+    }
+    for (auto _ : state)
+    {
+        signal.emit(1);
+        thread.sendWait([](){});
+    }
+    benchmark::DoNotOptimize(sum.load());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignalEmitCrossThread)->ArgName("slots")->Arg(1)->Arg(10)->Arg(100)->UseRealTime();
+
+/// @brief cost of emitting a signal to listeners spread over several threads without waiting for them
+static void BM_SignalEmitManyThreads(benchmark::State& state)
+{
+    constexpr const std::int64_t ThreadCount { 4 };
+    gusc::Threads::Thread threads[ThreadCount];
+    for (auto& thread : threads)
+    {
+        thread.start();
+    }
+    gusc::Threads::Signal<int> signal;
+    std::atomic<std::int64_t> sum { 0 };
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        signal.connect(&threads[i % ThreadCount], [&sum](const int& value){
+            sum.fetch_add(value, std::memory_order_relaxed);
+        });
+    }
+    for (auto _ : state)
+    {
+        signal.emit(1);
+    }
+    for (auto& thread : threads)
+    {
+        thread.sendWait([](){});
+    }
+    benchmark::DoNotOptimize(sum.load());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SignalEmitManyThreads)->ArgName("slots")->Arg(1)->Arg(10)->Arg(100)->UseRealTime();
+
+namespace
+{
+
+/// @brief emit a burst of updates to one listener thread and wait until the listener has caught up
+/// @note listener spends 2 µs per call (i.e. redrawing a progress bar), so it can't keep up with the emitter
+template<typename TSignal>
+void emitBurst(benchmark::State& state)
+{
+    gusc::Threads::Thread thread;
+    thread.start();
+    TSignal signal;
+    std::atomic<std::int64_t> last { 0 };
+    signal.connect(&thread, [&last](const int& value){
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < std::chrono::microseconds(2))
+        {
+        }
+        last.store(value, std::memory_order_relaxed);
+    });
+    const auto emitCount = state.range(1);
+    for (auto _ : state)
+    {
+        for (std::int64_t i = 0; i < emitCount; ++i)
+        {
+            signal.emit(static_cast<int>(i));
+        }
+        thread.sendWait([](){});
+    }
+    benchmark::DoNotOptimize(last.load());
+    state.SetItemsProcessed(state.iterations() * emitCount);
+}
+
+}
+
+/// @brief cost of a burst of emissions to a slow listener on another thread, with a message per emission or with coalesced emissions
+static void BM_SignalEmitCoalescing(benchmark::State& state)
+{
+    if (state.range(0))
+    {
+        emitBurst<gusc::Threads::CoalescingSignal<int>>(state);
+    }
+    else
+    {
+        emitBurst<gusc::Threads::Signal<int>>(state);
+    }
+}
+BENCHMARK(BM_SignalEmitCoalescing)->ArgNames({"coalescing", "emits"})->ArgsProduct({{0, 1}, {1000}})->UseRealTime();
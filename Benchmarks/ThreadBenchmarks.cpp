@@ -0,0 +1,235 @@
+//
+//  ThreadBenchmarks.cpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#include "Threads/Thread.hpp"
+#include "Threads/ThreadGroup.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/// @brief thread shared by all the benchmark threads of a multi-producer benchmark
+std::unique_ptr<gusc::Threads::Thread> sharedThread;
+
+/// @brief queue type selected by the first argument of a benchmark (0 - locking, 1 - lock-free, 2 - sharded)
+gusc::Threads::QueueType getQueueType(const benchmark::State& state)
+{
+    switch (state.range(0))
+    {
+        case 1:
+            return gusc::Threads::QueueType::LockFree;
+        case 2:
+            return gusc::Threads::QueueType::Sharded;
+        default:
+            return gusc::Threads::QueueType::Locking;
+    }
+}
+
+}
+
+/// @brief throughput of send with benchmark threads as producers, the run-loop is draining the queue at the same time
+static void BM_Send(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+    {
+        sharedThread = std::make_unique<gusc::Threads::Thread>(getQueueType(state));
+        sharedThread->start();
+    }
+    for (auto _ : state)
+    {
+        sharedThread->send([](){});
+    }
+    if (state.thread_index() == 0)
+    {
+        // Messages left in the queue are not counted, but they must not leak into the next run
+        sharedThread->sendWait([](){});
+        sharedThread.reset();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Send)->ArgName("queue")->Arg(0)->Arg(1)->Arg(2)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+
+/// @brief throughput of send while the run-loop keeps updating it's own state (spinning and batching), shows false sharing between the
+/// state producers read on every send and the state the run-loop writes
+static void BM_SendBusyConsumer(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+    {
+        gusc::Threads::ThreadOptions options;
+        options.queueType = getQueueType(state);
+        options.maxBatchSize = 64;
+        options.spinCycles = 1000;
+        sharedThread = std::make_unique<gusc::Threads::Thread>(options);
+        sharedThread->start();
+    }
+    for (auto _ : state)
+    {
+        sharedThread->send([](){});
+    }
+    if (state.thread_index() == 0)
+    {
+        sharedThread->sendWait([](){});
+        sharedThread.reset();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SendBusyConsumer)->ArgName("queue")->Arg(0)->Arg(1)->Arg(2)->Threads(4)->Threads(16)->UseRealTime();
+
+/// @brief cost of sending and executing a batch of messages, measured from the first send until the last message is executed
+static void BM_SendAndExecute(benchmark::State& state)
+{
+    gusc::Threads::Thread thread(getQueueType(state));
+    thread.start();
+    const auto messageCount = state.range(1);
+    std::atomic<std::int64_t> counter { 0 };
+    for (auto _ : state)
+    {
+        for (std::int64_t i = 0; i < messageCount; ++i)
+        {
+            thread.send([&counter](){
+                counter.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        thread.sendWait([](){});
+    }
+    benchmark::DoNotOptimize(counter.load());
+    state.SetItemsProcessed(state.iterations() * messageCount);
+}
+BENCHMARK(BM_SendAndExecute)->ArgNames({"queue", "messages"})->ArgsProduct({{0, 1, 2}, {1000}})->UseRealTime();
+
+/// @brief cost of messages the run-loop sends to itself (i.e. queued signal deliveries of messages running on the listener's thread)
+static void BM_SendNested(benchmark::State& state)
+{
+    gusc::Threads::Thread thread(getQueueType(state));
+    thread.start();
+    const auto messageCount = state.range(1);
+    for (auto _ : state)
+    {
+        thread.send([&thread, messageCount](){
+            for (std::int64_t i = 0; i < messageCount; ++i)
+            {
+                thread.send([](){});
+            }
+        });
+        thread.sendWait([](){});
+    }
+    state.SetItemsProcessed(state.iterations() * messageCount);
+}
+BENCHMARK(BM_SendNested)->ArgNames({"queue", "messages"})->ArgsProduct({{0, 1, 2}, {1000}})->UseRealTime();
+
+/// @brief round-trip latency of sendSync
+static void BM_SendSync(benchmark::State& state)
+{
+    gusc::Threads::Thread thread(getQueueType(state));
+    thread.start();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(thread.sendSync<int>([]() -> int {
+            return 1;
+        }));
+    }
+}
+BENCHMARK(BM_SendSync)->ArgName("queue")->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+
+/// @brief cost of placing a delayed message on the delayed queue
+static void BM_SendDelayedInsert(benchmark::State& state)
+{
+    gusc::Threads::Thread thread(getQueueType(state));
+    thread.start();
+    std::vector<gusc::Threads::Thread::TimerHandle> handles;
+    handles.reserve(1000000);
+    for (auto _ : state)
+    {
+        handles.push_back(thread.sendDelayed([](){}, 1h));
+        if (handles.size() == 1000000)
+        {
+            state.PauseTiming();
+            for (auto& handle : handles)
+            {
+                handle.cancel();
+            }
+            handles.clear();
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SendDelayedInsert)->ArgName("queue")->Arg(0)->Arg(1)->Arg(2);
+
+/// @brief cost of inserting and firing delayed messages that are already due (includes waiting for the next 1 ms tick of the timer wheel)
+static void BM_SendDelayedFire(benchmark::State& state)
+{
+    gusc::Threads::Thread thread(getQueueType(state));
+    thread.start();
+    const auto messageCount = state.range(1);
+    std::atomic<std::int64_t> counter { 0 };
+    for (auto _ : state)
+    {
+        counter = 0;
+        for (std::int64_t i = 0; i < messageCount; ++i)
+        {
+            thread.sendDelayed([&counter](){
+                counter.fetch_add(1, std::memory_order_relaxed);
+            }, 0ms);
+        }
+        while (counter.load(std::memory_order_relaxed) < messageCount)
+        {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * messageCount);
+}
+BENCHMARK(BM_SendDelayedFire)->ArgNames({"queue", "messages"})->ArgsProduct({{0, 1, 2}, {1000}})->UseRealTime();
+
+/// @brief time to stop 200 threads with 100 leftover messages each, one by one (as destructors do) or all together with a ThreadGroup
+static void BM_Shutdown(benchmark::State& state)
+{
+    constexpr const std::size_t ThreadCount { 200 };
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<std::unique_ptr<gusc::Threads::Thread>> threads;
+        gusc::Threads::ThreadGroup group;
+        for (std::size_t i = 0; i < ThreadCount; ++i)
+        {
+            auto& thread = threads.emplace_back(std::make_unique<gusc::Threads::Thread>());
+            thread->start();
+            for (auto j = 0; j < 100; ++j)
+            {
+                thread->send([](){
+                    benchmark::ClobberMemory();
+                });
+            }
+            group.add(thread.get());
+        }
+        state.ResumeTiming();
+        if (state.range(0))
+        {
+            group.shutdown();
+        }
+        else
+        {
+            for (auto& thread : threads)
+            {
+                thread->stop();
+                thread->join();
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ThreadCount);
+}
+BENCHMARK(BM_Shutdown)->ArgName("group")->Arg(0)->Arg(1)->UseRealTime();
@@ -0,0 +1,177 @@
+//
+//  CoroutineTests.cpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#include "CoroutineTests.hpp"
+#include "Utilities.hpp"
+#include "Threads/Coroutine.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+static Logger corlog;
+}
+
+#if defined(THREADS_HAS_COROUTINES)
+
+namespace
+{
+
+gusc::Threads::Task hopBetweenThreads(gusc::Threads::Thread& first, gusc::Threads::Thread& second, std::promise<std::string>& result)
+{
+    std::string path;
+    co_await first;
+    path += (first == std::this_thread::get_id()) ? "first" : "other";
+    co_await second;
+    path += (second == std::this_thread::get_id()) ? " second" : " other";
+    const auto value = co_await first.sendFuture<int>([]() -> int {
+        return 42;
+    });
+    path += " " + std::to_string(value);
+    try
+    {
+        co_await second.sendFuture<void>([](){
+            throw std::runtime_error("failed");
+        });
+    }
+    catch (const std::exception& e)
+    {
+        path += std::string(" ") + e.what();
+    }
+    result.set_value(path);
+}
+
+gusc::Threads::Task waitForSignals(gusc::Threads::Thread& thread, gusc::Threads::Signal<int, std::string>& sigArgs, gusc::Threads::Signal<void>& sigSimple, std::promise<std::string>& result)
+{
+    const auto [number, text] = co_await gusc::Threads::nextEmission(sigArgs, &thread);
+    auto path = std::to_string(number) + " " + text + ((thread == std::this_thread::get_id()) ? " on thread" : " elsewhere");
+    co_await gusc::Threads::nextEmission(sigSimple, &thread);
+    result.set_value(path + " simple");
+}
+
+/// @brief counts the destroyed coroutine frames
+struct FrameGuard
+{
+    std::atomic<int>& destroyedFrames;
+    ~FrameGuard()
+    {
+        ++destroyedFrames;
+    }
+};
+
+gusc::Threads::Task awaitDroppedMessage(gusc::Threads::Thread& thread, std::atomic<int>& destroyedFrames, std::promise<std::string>& result)
+{
+    FrameGuard guard{destroyedFrames};
+    try
+    {
+        co_await thread;
+        result.set_value("resumed on the thread");
+    }
+    catch (const std::future_error& e)
+    {
+        result.set_value((e.code() == std::future_errc::broken_promise) ? "broken promise" : e.what());
+    }
+}
+
+gusc::Threads::Task waitForCoalesced(gusc::Threads::Thread& thread, gusc::Threads::CoalescingSignal<int>& signal, std::promise<int>& result)
+{
+    result.set_value(co_await gusc::Threads::nextEmission(signal, &thread));
+}
+
+}
+
+void runCoroutineTests()
+{
+    corlog << "Coroutine Tests";
+
+    gusc::Threads::Thread t1;
+    gusc::Threads::Thread t2;
+    t1.start();
+    t2.start();
+
+    std::promise<std::string> hopPromise;
+    auto hopFuture = hopPromise.get_future();
+    hopBetweenThreads(t1, t2, hopPromise);
+    corlog << "Coroutine hops: " + hopFuture.get();
+
+    gusc::Threads::Signal<int, std::string> sigArgs;
+    gusc::Threads::Signal<void> sigSimple;
+    std::promise<std::string> signalPromise;
+    auto signalFuture = signalPromise.get_future();
+    t1.sendWait([&](){
+        waitForSignals(t1, sigArgs, sigSimple, signalPromise);
+    });
+    sigArgs.emit(7, "seven");
+    // Second emission should not reach the awaiter (it's disconnected or waiting for the other signal)
+    sigArgs.emit(8, "eight");
+    // Let the coroutine connect to the next signal
+    t1.sendWait([](){});
+    sigSimple.emit();
+    corlog << "Coroutine signals: " + signalFuture.get();
+
+    gusc::Threads::CoalescingSignal<int> sigCoalesced;
+    std::promise<int> coalescedPromise;
+    auto coalescedFuture = coalescedPromise.get_future();
+    t1.sendWait([&](){
+        waitForCoalesced(t1, sigCoalesced, coalescedPromise);
+    });
+    sigCoalesced.emit(3);
+    corlog << "Coroutine coalesced signal: " + std::to_string(coalescedFuture.get());
+
+    // Coroutine is resumed with an error when the message resuming it is dropped
+    std::atomic<int> destroyedFrames { 0 };
+    gusc::Threads::ThreadOptions boundedOptions;
+    boundedOptions.capacity = 1;
+    boundedOptions.overflowPolicy = gusc::Threads::OverflowPolicy::DropNewest;
+    gusc::Threads::Thread t3(boundedOptions);
+    t3.send([](){});
+    std::promise<std::string> droppedPromise;
+    auto droppedFuture = droppedPromise.get_future();
+    awaitDroppedMessage(t3, destroyedFrames, droppedPromise);
+    corlog << "Coroutine dropped by a full queue: " + droppedFuture.get() + ", frames destroyed: " + std::to_string(destroyedFrames.load());
+
+    gusc::Threads::Thread t4;
+    t4.start();
+    std::promise<void> blockerStarted;
+    std::promise<void> blockerRelease;
+    t4.send([&blockerStarted, blocker = blockerRelease.get_future().share()](){
+        blockerStarted.set_value();
+        blocker.wait();
+    });
+    blockerStarted.get_future().wait();
+    std::promise<std::string> deadlinePromise;
+    auto deadlineFuture = deadlinePromise.get_future();
+    awaitDroppedMessage(t4, destroyedFrames, deadlinePromise);
+    gusc::Threads::ShutdownOptions deadlineOptions;
+    deadlineOptions.deadline = std::chrono::steady_clock::now();
+    t4.stop(deadlineOptions);
+    blockerRelease.set_value();
+    t4.join();
+    corlog << "Coroutine dropped by the shutdown deadline: " + deadlineFuture.get() + ", frames destroyed: "
+        + std::to_string(destroyedFrames.load()) + ", dropped messages: " + std::to_string(t4.takeShutdownReport().droppedMessages);
+
+    t1.stop();
+    t2.stop();
+    t1.join();
+    t2.join();
+    corlog.flush();
+}
+
+#else
+
+void runCoroutineTests()
+{
+    corlog << "Coroutine Tests skipped - coroutines are not supported by the compiler";
+    corlog.flush();
+}
+
+#endif
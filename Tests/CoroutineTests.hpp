@@ -0,0 +1,14 @@
+//
+//  CoroutineTests.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef CoroutineTests_hpp
+#define CoroutineTests_hpp
+
+void runCoroutineTests();
+
+#endif /* CoroutineTests_hpp */
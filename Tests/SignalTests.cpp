@@ -10,8 +10,18 @@
 #include "Utilities.hpp"
 #include "Threads/Thread.hpp"
 #include "Threads/Signal.hpp"
+#include "Threads/CoalescingSignal.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <future>
+#if defined(THREADS_ENABLE_TRACING)
+#   include <sstream>
+#   include <string>
+#endif
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 namespace
 {
@@ -54,6 +64,10 @@ void argumentFunction(int a, bool b)
     slog << "Argument function thread ID: " + tidToStr(std::this_thread::get_id()) + ", " + std::to_string(a) + ", " + std::to_string(b);
 }
 
+void churnFunction(const int&)
+{
+}
+
 void objectFunction(const Object& obj)
 {
     slog << "Object function thread ID: " + tidToStr(std::this_thread::get_id()) + ", " + obj.getVal();
@@ -93,6 +107,16 @@ public:
     }
 };
 
+class CounterThread : public gusc::Threads::Thread
+{
+public:
+    void add(const int& value)
+    {
+        sum += value;
+    }
+    int sum { 0 };
+};
+
 static const auto simpleConstLambda = [](){
    slog << "Simple const lambda thread ID: " + tidToStr(std::this_thread::get_id());
 };
@@ -190,6 +214,13 @@ void runSignalTests()
     sigSimple.emit();
     sigArgs.emit(1, false);
     sigObject.emit(o);
+    // Emit with the data shared by all the listeners on other threads
+    Object shared("SHARED");
+    sigArgs.emitShared(3, true);
+    sigObject.emitShared(shared);
+    // Emit multiple times with a single message per listener's thread
+    sigArgs.emitBatch({{4, false}, {5, true}});
+    sigSimple.emitBatch({{}, {}});
     std::async([&sigSimple, &sigArgs, &sigObject]()
     {
         Object o{"QWERTY"};
@@ -244,4 +275,178 @@ void runSignalTests()
     sigSimple.disconnect(&ct, &CustomThread::listenSimple);
     sigArgs.disconnect(&ct, &CustomThread::listenArgs);
     sigObject.disconnect(&ct, &CustomThread::listenObject);
+    
+    // Connect and disconnect many short-lived listeners, connection IDs of removed slots must not match new slots
+    gusc::Threads::Thread local;
+    gusc::Threads::Signal<int> sigChurn;
+    int churnSum { 0 };
+    std::vector<std::size_t> churnIds;
+    for (auto i = 0; i < 1000; ++i)
+    {
+        churnIds.push_back(sigChurn.connect(&local, [&churnSum, i](const int& v){
+            churnSum += v * i;
+        }));
+    }
+    for (std::size_t i = 0; i < churnIds.size(); i += 2)
+    {
+        sigChurn.disconnect(churnIds[i]);
+    }
+    const auto staleId = churnIds[0];
+    const auto reusedId = sigChurn.connect(&local, [&churnSum](const int& v){
+        churnSum += v * 1000000;
+    });
+    const auto isStaleRemoved = sigChurn.disconnect(staleId);
+    const auto isDuplicate = sigChurn.connect(&local, &churnFunction) == sigChurn.connect(&local, &churnFunction);
+    sigChurn.disconnect(&local, &churnFunction);
+    sigChurn.emit(1);
+    slog << "Signal churn sum: " + std::to_string(churnSum) + ", stale ID disconnected: " + std::to_string(isStaleRemoved)
+        + ", ID reused: " + std::to_string(reusedId == staleId) + ", duplicate connection: " + std::to_string(isDuplicate);
+    
+    // Member methods known at compile time
+    CounterThread counter;
+    gusc::Threads::Signal<int> sigTypedMethod;
+    const auto isTypedDuplicate = sigTypedMethod.connect<&CounterThread::add>(&counter) == sigTypedMethod.connect<&CounterThread::add>(&counter);
+    sigTypedMethod.connect(&counter, &CounterThread::add);
+    sigTypedMethod.emit(2);
+    const auto isTypedDisconnected = sigTypedMethod.disconnect<&CounterThread::add>(&counter);
+    sigTypedMethod.emit(3);
+    slog << "Signal typed method sum: " + std::to_string(counter.sum) + ", duplicate connection: " + std::to_string(isTypedDuplicate)
+        + ", disconnected: " + std::to_string(isTypedDisconnected);
+    
+    // Connection types
+    gusc::Threads::Thread typed;
+    typed.start();
+    gusc::Threads::Signal<int> sigTyped;
+    std::thread::id directThreadId;
+    std::atomic<bool> isBlockingDone { false };
+    sigTyped.connect(&typed, [&directThreadId](const int&){
+        directThreadId = std::this_thread::get_id();
+    }, gusc::Threads::ConnectionType::Direct);
+    sigTyped.connect(&typed, [&isBlockingDone](const int&){
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        isBlockingDone = true;
+    }, gusc::Threads::ConnectionType::BlockingQueued);
+    sigTyped.emit(1);
+    const auto isDirectInline = directThreadId == std::this_thread::get_id();
+    const auto isBlocking = isBlockingDone.load();
+    gusc::Threads::Signal<void> sigQueued;
+    bool isEmitDone { false };
+    bool isQueuedAfterEmit { false };
+    sigQueued.connect(&typed, [&isEmitDone, &isQueuedAfterEmit](){
+        isQueuedAfterEmit = isEmitDone;
+    }, gusc::Threads::ConnectionType::Queued);
+    typed.sendWait([&sigQueued, &isEmitDone](){
+        sigQueued.emit();
+        isEmitDone = true;
+    });
+    typed.sendWait([](){});
+    slog << "Signal direct called inline: " + std::to_string(isDirectInline) + ", blocking finished before emit returned: "
+        + std::to_string(isBlocking) + ", queued called after emit: " + std::to_string(isQueuedAfterEmit);
+
+    
+    // Failing hosts don't stop the emission for the other hosts and the first error is re-thrown from emit
+    gusc::Threads::Thread failing;
+    failing.start();
+    gusc::Threads::Thread stopped;
+    stopped.start();
+    stopped.stop();
+    stopped.join();
+    gusc::Threads::Signal<int> sigFailing;
+    std::atomic<int> failingDelivered { 0 };
+    sigFailing.connect(&failing, [](const int&){
+        throw std::runtime_error("listener failure");
+    }, gusc::Threads::ConnectionType::BlockingQueued);
+    sigFailing.connect(&typed, [&failingDelivered](const int& v){
+        failingDelivered += v;
+    }, gusc::Threads::ConnectionType::BlockingQueued);
+    std::string failingError;
+    try
+    {
+        sigFailing.emit(1);
+    }
+    catch (const std::exception& ex)
+    {
+        failingError = ex.what();
+    }
+    gusc::Threads::Signal<int> sigStopped;
+    sigStopped.connect(&stopped, [&failingDelivered](const int& v){
+        failingDelivered += v;
+    }, gusc::Threads::ConnectionType::BlockingQueued);
+    sigStopped.connect(&typed, [&failingDelivered](const int& v){
+        failingDelivered += v;
+    }, gusc::Threads::ConnectionType::BlockingQueued);
+    bool isStoppedReported { false };
+    try
+    {
+        sigStopped.emit(10);
+    }
+    catch (const std::runtime_error&)
+    {
+        isStoppedReported = true;
+    }
+    slog << "Blocking listener error: " + failingError + ", stopped host reported: " + std::to_string(isStoppedReported)
+        + ", delivered to the other hosts: " + std::to_string(failingDelivered.load());    
+    // Coalescing signal delivers only the latest arguments to a busy listener
+    static_assert(!std::is_convertible_v<gusc::Threads::CoalescingSignal<int>*, gusc::Threads::Signal<int>*>, "Emissions must not bypass coalescing");
+    gusc::Threads::Thread coalesced;
+    coalesced.start();
+    gusc::Threads::CoalescingSignal<int> sigCoalesced;
+    int coalescedCalls { 0 };
+    int coalescedValue { 0 };
+    sigCoalesced.connect(&coalesced, [&coalescedCalls, &coalescedValue](const int& v){
+        ++coalescedCalls;
+        coalescedValue = v;
+    });
+    std::promise<void> coalescedRelease;
+    coalesced.send([release = coalescedRelease.get_future().share()](){
+        release.wait();
+    });
+    for (auto i = 1; i <= 100; ++i)
+    {
+        sigCoalesced.emit(i);
+    }
+    coalescedRelease.set_value();
+    coalesced.sendWait([](){});
+    const auto coalescedFirstCalls = coalescedCalls;
+    const auto coalescedFirstValue = coalescedValue;
+    sigCoalesced.emit(101);
+    coalesced.sendWait([](){});
+    gusc::Threads::CoalescingSignal<void> sigCoalescedVoid;
+    int coalescedVoidCalls { 0 };
+    sigCoalescedVoid.connect(&coalesced, [&coalescedVoidCalls](){
+        ++coalescedVoidCalls;
+    });
+    sigCoalescedVoid.emit();
+    coalesced.sendWait([](){});
+    slog << "Coalesced calls: " + std::to_string(coalescedFirstCalls) + ", value: " + std::to_string(coalescedFirstValue)
+        + ", calls after next emit: " + std::to_string(coalescedCalls) + ", value: " + std::to_string(coalescedValue)
+        + ", void calls: " + std::to_string(coalescedVoidCalls);
+
+#if defined(THREADS_ENABLE_TRACING)
+    // Tracing
+    gusc::Threads::Tracer::clear();
+    gusc::Threads::Thread traced;
+    traced.start();
+    gusc::Threads::Signal<int> sigTraced;
+    sigTraced.connect(&traced, [](const int&){});
+    for (auto i = 0; i < 10; ++i)
+    {
+        traced.send([](){});
+    }
+    sigTraced.emit(1);
+    traced.sendWait([](){});
+    std::ostringstream trace;
+    gusc::Threads::Tracer::writeChromeTrace(trace);
+    const auto countEvents = [text = trace.str()](const std::string& pattern){
+        std::size_t count { 0 };
+        for (auto position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1))
+        {
+            ++count;
+        }
+        return std::to_string(count);
+    };
+    slog << "Traced messages: " + countEvents("\"ph\":\"B\"") + ", flows: " + countEvents("\"message\",\"ph\":\"f\"")
+        + ", emits: " + countEvents("\"emit\"") + ", deliveries: " + countEvents("\"deliver\"")
+        + ", signal flows: " + countEvents("\"signal\",\"ph\":\"s\"") + "/" + countEvents("\"signal\",\"ph\":\"f\"");
+#endif
 }
@@ -0,0 +1,120 @@
+//
+//  ThreadPoolTests.cpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#include "ThreadPoolTests.hpp"
+#include "Utilities.hpp"
+#include "Threads/ThreadPool.hpp"
+#include "Threads/Signal.hpp"
+
+#include <atomic>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+static Logger plog;
+}
+
+void runThreadPoolTests()
+{
+    plog << "Thread Pool Tests";
+    
+    gusc::Threads::ThreadPool pool(4);
+    std::atomic<int> counter { 0 };
+    
+    // Test sending before start
+    pool.send([&counter](){
+        ++counter;
+    });
+    try
+    {
+        pool.sendWait([](){});
+    }
+    catch (const std::exception& ex)
+    {
+        plog << ex.what();
+    }
+    pool.start();
+    
+    // Test a slow message not holding up the rest of the messages
+    std::atomic<int> slowCounter { 0 };
+    pool.send([&counter, &slowCounter](){
+        std::this_thread::sleep_for(200ms);
+        slowCounter = counter.load();
+    });
+    std::vector<std::thread> producers;
+    for (auto i = 0; i < 2; ++i)
+    {
+        producers.emplace_back([&pool, &counter](){
+            for (auto j = 0; j < 1000; ++j)
+            {
+                pool.send([&counter](){
+                    ++counter;
+                });
+            }
+        });
+    }
+    for (auto& p : producers)
+    {
+        p.join();
+    }
+    
+    // Test fan-out from a worker (sub-messages go to the worker's own queue and get stolen by others)
+    std::atomic<int> fanOutCounter { 0 };
+    pool.send([&pool, &fanOutCounter](){
+        for (auto i = 0; i < 100; ++i)
+        {
+            pool.send([&fanOutCounter](){
+                std::this_thread::sleep_for(1ms);
+                ++fanOutCounter;
+            });
+        }
+    });
+    
+    // Test sync and async results
+    auto f1 = pool.sendAsync<int>([&pool]() -> int {
+        // Try to do a blocking call from a worker thread
+        return pool.sendSync<int>([]() -> int {
+            return 10;
+        });
+    });
+    auto res1 = pool.sendSync<int>([]() -> int {
+        return 1;
+    });
+    auto res2 = pool.sendSync<int>([value = std::make_unique<int>(2)](){
+        return *value;
+    });
+    while (counter < 2001 || fanOutCounter < 100 || slowCounter == 0)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    plog << "Thread pool sync and async results" << std::to_string(f1.get()) << std::to_string(res1) << std::to_string(res2);
+    plog << "Thread pool messages processed: " + std::to_string(counter) + ", fan-out messages processed: " + std::to_string(fanOutCounter) + ", processed while a slow message was running: " + std::to_string(slowCounter);
+    plog.flush();
+    
+    // Test signals targeting the pool
+    gusc::Threads::Signal<int> sigValue;
+    gusc::Threads::Signal<void> sigSimple;
+    std::atomic<int> signalCounter { 0 };
+    sigValue.connect(&pool, [&signalCounter](int value){
+        signalCounter += value;
+    });
+    sigSimple.connect(&pool, [&signalCounter](){
+        ++signalCounter;
+    });
+    for (auto i = 0; i < 10; ++i)
+    {
+        sigValue.emit(10);
+        sigSimple.emit();
+    }
+    pool.stop();
+    pool.join();
+    plog << "Thread pool signals received: " + std::to_string(signalCounter);
+    plog.flush();
+}
@@ -0,0 +1,14 @@
+//
+//  ThreadPoolTests.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef ThreadPoolTests_hpp
+#define ThreadPoolTests_hpp
+
+void runThreadPoolTests();
+
+#endif /* ThreadPoolTests_hpp */
@@ -9,8 +9,19 @@
 #include "ThreadTests.hpp"
 #include "Utilities.hpp"
 #include "Threads/Thread.hpp"
+#include "Threads/ThreadGroup.hpp"
 
+#include <array>
 #include <chrono>
+#include <functional>
+#if defined(__linux__)
+#   include <pthread.h>
+#   include <sched.h>
+#endif
+#if defined(THREADS_HAS_EVENT_WAIT)
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
 
 using namespace std::chrono_literals;
 
@@ -110,6 +121,16 @@ void runThreadTests()
     t1.send(globalConstLambda);
     t2.send(globalConstLambda);
     
+    // Test lambdas with small and large captures (pool blocks and global allocator)
+    const std::array<std::size_t, 4> smallCapture { 1, 2, 3, 4 };
+    const std::array<std::size_t, 512> largeCapture { 1, 2, 3, 4 };
+    mt.send([smallCapture](){
+        tlog << "Small capture lambda thread ID: " + tidToStr(std::this_thread::get_id()) + ", " + std::to_string(smallCapture[3]);
+    });
+    t1.send([largeCapture](){
+        tlog << "Large capture lambda thread ID: " + tidToStr(std::this_thread::get_id()) + ", " + std::to_string(largeCapture[3]);
+    });
+    
     // Test anonymous lambda
     mt.send([](){
         tlog << "Anonymous lambda thread ID: " + tidToStr(std::this_thread::get_id());
@@ -176,7 +197,705 @@ void runThreadTests()
     });
     tlog << "Sync and async results" << std::to_string(f1.get()) << std::to_string(f2.get()) << std::to_string(res1) << std::to_string(res2);
     tlog.flush();
+
+    // Test move-only callables
+    auto payload = std::make_unique<std::string>("payload");
+    t1.send([payload = std::move(payload)](){
+        tlog << "Move-only lambda thread ID: " + tidToStr(std::this_thread::get_id()) + ", " + *payload;
+    });
+    std::promise<int> movedPromise;
+    auto movedFuture = movedPromise.get_future();
+    t2.sendDelayed([movedPromise = std::move(movedPromise)]() mutable {
+        movedPromise.set_value(30);
+    }, 10ms);
+    auto res4 = t1.sendSync<int>([value = std::make_unique<int>(40)](){
+        return *value;
+    });
+    tlog << "Move-only results" << std::to_string(movedFuture.get()) << std::to_string(res4);
+    tlog.flush();
+
+    // Test lock-free queue with multiple producers
+    gusc::Threads::Thread t3(gusc::Threads::QueueType::LockFree);
+    t3.sendDelayed([](){
+        tlog << "Lock-free delayed message on thread ID: " + tidToStr(std::this_thread::get_id());
+    }, 100ms);
+    t3.start();
+    std::atomic<int> lockFreeCounter { 0 };
+    std::vector<std::thread> producers;
+    for (auto i = 0; i < 4; ++i)
+    {
+        producers.emplace_back([&t3, &lockFreeCounter](){
+            for (auto j = 0; j < 1000; ++j)
+            {
+                t3.send([&lockFreeCounter](){
+                    ++lockFreeCounter;
+                });
+            }
+        });
+    }
+    for (auto& p : producers)
+    {
+        p.join();
+    }
+    auto res3 = t3.sendSync<int>([&lockFreeCounter]() -> int {
+        return lockFreeCounter;
+    });
+    tlog << "Lock-free queue messages processed: " + std::to_string(res3);
+    tlog.flush();
+
+    // Test sharded queue with multiple producers, messages of every producer must stay in order
+    gusc::Threads::Thread t16(gusc::Threads::QueueType::Sharded);
+    t16.sendDelayed([](){
+        tlog << "Sharded delayed message on thread ID: " + tidToStr(std::this_thread::get_id());
+    }, 100ms);
+    t16.start();
+    std::vector<int> shardedLast(4, -1);
+    std::atomic<int> shardedOutOfOrder { 0 };
+    std::vector<std::thread> shardedProducers;
+    for (auto i = 0; i < 4; ++i)
+    {
+        shardedProducers.emplace_back([&t16, &shardedLast, &shardedOutOfOrder, i](){
+            for (auto j = 0; j < 1000; ++j)
+            {
+                t16.send([&shardedLast, &shardedOutOfOrder, i, j](){
+                    if (shardedLast[i] + 1 != j)
+                    {
+                        ++shardedOutOfOrder;
+                    }
+                    shardedLast[i] = j;
+                });
+            }
+        });
+    }
+    for (auto& p : shardedProducers)
+    {
+        p.join();
+    }
+    auto res16 = t16.sendSync<int>([&shardedLast]() -> int {
+        auto count { 0 };
+        for (const auto last : shardedLast)
+        {
+            count += last + 1;
+        }
+        return count;
+    });
+    tlog << "Sharded queue messages processed: " + std::to_string(res16) + ", out of order: " + std::to_string(shardedOutOfOrder);
+    tlog.flush();
+
+    // Test batched draining
+    gusc::Threads::Thread t4(gusc::Threads::ThreadOptions{gusc::Threads::QueueType::Locking, 64});
+    t4.start();
+    std::atomic<int> batchCounter { 0 };
+    t4.sendDelayed([](){
+        tlog << "Batched delayed message on thread ID: " + tidToStr(std::this_thread::get_id());
+    }, 10ms);
+    for (auto i = 0; i < 1000; ++i)
+    {
+        t4.send([&batchCounter](){
+            ++batchCounter;
+        });
+    }
+    auto res5 = t4.sendSync<int>([&batchCounter]() -> int {
+        return batchCounter;
+    });
+    tlog << "Batched queue messages processed: " + std::to_string(res5);
+    tlog.flush();
+
+    // Test bulk sends on both queue types
+    std::atomic<int> bulkCounter { 0 };
+    std::vector<std::function<void()>> bulkMessages(100, [&bulkCounter](){
+        ++bulkCounter;
+    });
+    t3.sendBatch(bulkMessages);
+    t4.sendBatch(bulkMessages.begin(), bulkMessages.end());
+    t4.sendBatch(std::move(bulkMessages));
+    const auto batchedLambda = [](){
+        tlog << "Batched message on thread ID: " + tidToStr(std::this_thread::get_id());
+    };
+    t3.sendBatch({batchedLambda, batchedLambda});
+    t3.sendWait([](){});
+    auto res8 = t4.sendSync<int>([&bulkCounter]() -> int {
+        return bulkCounter;
+    });
+    tlog << "Bulk messages processed: " + std::to_string(res8);
+    tlog.flush();
+
+    // Test spinning before parking
+    gusc::Threads::ThreadOptions spinningOptions;
+    spinningOptions.queueType = gusc::Threads::QueueType::LockFree;
+    spinningOptions.spinCycles = 1000;
+    gusc::Threads::Thread t5(spinningOptions);
+    t5.start();
+    auto res6 { 0 };
+    for (auto i = 0; i < 100; ++i)
+    {
+        res6 += t5.sendSync<int>([]() -> int {
+            return 1;
+        });
+    }
+    tlog << "Spinning thread round trips: " + std::to_string(res6);
+    tlog.flush();
+
+    // Test many delayed messages with the same deadline
+    std::atomic<int> delayedCounter { 0 };
+    for (auto i = 0; i < 1000; ++i)
+    {
+        t4.sendDelayed([&delayedCounter](){
+            ++delayedCounter;
+        }, 5ms);
+    }
+    t4.sendDelayed([](){
+        tlog << "Far away delayed message on thread ID: " + tidToStr(std::this_thread::get_id());
+    }, 24h);
+    std::this_thread::sleep_for(50ms);
+    auto res7 = t4.sendSync<int>([&delayedCounter]() -> int {
+        return delayedCounter;
+    });
+    tlog << "Delayed messages processed: " + std::to_string(res7);
+    tlog.flush();
+
+    // Test cancelling and rescheduling delayed messages
+    auto cancelled = t4.sendDelayed([](){
+        tlog << "Cancelled delayed message should not run";
+    }, 10ms);
+    auto rescheduled = t4.sendDelayed([](){
+        tlog << "Rescheduled delayed message on thread ID: " + tidToStr(std::this_thread::get_id());
+    }, 1h);
+    auto isCancelled = cancelled.cancel();
+    auto isCancelledTwice = cancelled.cancel();
+    auto isRescheduled = rescheduled.reschedule(10ms);
+    std::this_thread::sleep_for(50ms);
+    tlog << "Timer handles cancel: " + std::to_string(isCancelled) + ", second cancel: " + std::to_string(isCancelledTwice) + ", reschedule: " + std::to_string(isRescheduled) + ", reschedule after timeout: " + std::to_string(rescheduled.reschedule(10ms));
+    tlog.flush();
+
+    // Test bounded queues with different overflow policies
+    gusc::Threads::ThreadOptions boundedOptions;
+    boundedOptions.capacity = 4;
+    std::string droppedNewest;
+    std::string droppedOldest;
+    boundedOptions.overflowPolicy = gusc::Threads::OverflowPolicy::DropNewest;
+    gusc::Threads::Thread t6(boundedOptions);
+    boundedOptions.overflowPolicy = gusc::Threads::OverflowPolicy::DropOldest;
+    gusc::Threads::Thread t7(boundedOptions);
+    boundedOptions.overflowPolicy = gusc::Threads::OverflowPolicy::Fail;
+    gusc::Threads::Thread t8(boundedOptions);
+    for (auto i = 0; i < 10; ++i)
+    {
+        t6.send([&droppedNewest, i](){
+            droppedNewest += std::to_string(i);
+        });
+        t7.send([&droppedOldest, i](){
+            droppedOldest += std::to_string(i);
+        });
+    }
+    auto isTrySent = t6.trySend([](){});
+    try
+    {
+        for (auto i = 0; i < 10; ++i)
+        {
+            t8.send([](){});
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        tlog << ex.what();
+    }
+    t6.start();
+    t7.start();
+    t6.stop();
+    t7.stop();
+    t6.join();
+    t7.join();
+    tlog << "Bounded queue drop newest: " + droppedNewest + ", drop oldest: " + droppedOldest + ", try send on full queue: " + std::to_string(isTrySent);
     
+    boundedOptions.capacity = 2;
+    boundedOptions.overflowPolicy = gusc::Threads::OverflowPolicy::Block;
+    gusc::Threads::Thread t9(boundedOptions);
+    t9.start();
+    std::promise<void> blockingPromise;
+    t9.send([blockingFuture = blockingPromise.get_future()]() mutable {
+        blockingFuture.wait();
+    });
+    std::atomic<int> blockedCounter { 0 };
+    std::thread blockedProducer([&t9, &blockedCounter](){
+        for (auto i = 0; i < 10; ++i)
+        {
+            t9.send([&blockedCounter](){
+                ++blockedCounter;
+            });
+        }
+    });
+    std::this_thread::sleep_for(10ms);
+    blockingPromise.set_value();
+    blockedProducer.join();
+    auto res9 = t9.sendSync<int>([&blockedCounter]() -> int {
+        return blockedCounter;
+    });
+    tlog << "Bounded queue blocked sender messages processed: " + std::to_string(res9);
+    tlog.flush();
+
+    // Test synchronous messages that throw or are discarded
+    boundedOptions.capacity = 1;
+    boundedOptions.overflowPolicy = gusc::Threads::OverflowPolicy::DropOldest;
+    gusc::Threads::Thread t19(boundedOptions);
+    t19.start();
+    std::string syncError;
+    try
+    {
+        t19.sendSync<int>([]() -> int {
+            throw std::runtime_error("sync failure");
+        });
+    }
+    catch (const std::exception& ex)
+    {
+        syncError = ex.what();
+    }
+    std::promise<void> discardPromise;
+    t19.send([discardFuture = discardPromise.get_future()]() mutable {
+        discardFuture.wait();
+    });
+    std::this_thread::sleep_for(10ms);
+    auto discardedFuture = std::async(std::launch::async, [&t19](){
+        try
+        {
+            t19.sendWait([](){});
+            return false;
+        }
+        catch (const std::future_error&)
+        {
+            return true;
+        }
+    });
+    std::this_thread::sleep_for(10ms);
+    // Pushes the waiting message out of the full queue
+    t19.send([](){});
+    discardPromise.set_value();
+    tlog << "Sync message exception: " + syncError + ", discarded sync message reported: " + std::to_string(discardedFuture.get());
+    tlog.flush();
+
+    // Test messages a run-loop sends to itself
+    gusc::Threads::Thread t20;
+    t20.start();
+    std::string nestedOrder;
+    bool isCurrentLoop { false };
+    t20.sendWait([&t20, &nestedOrder, &isCurrentLoop](){
+        isCurrentLoop = gusc::Threads::Thread::getCurrent() == &t20;
+        t20.send([&nestedOrder](){
+            nestedOrder += "2";
+        });
+        t20.send([&nestedOrder](){
+            nestedOrder += "3";
+        }, gusc::Threads::Priority::High);
+        nestedOrder += "1";
+    });
+    // Nested messages were sent before this one
+    t20.sendWait([](){});
+    tlog << "Nested messages order: " + nestedOrder + ", current run-loop: " + std::to_string(isCurrentLoop)
+        + ", no run-loop on the main thread: " + std::to_string(gusc::Threads::Thread::getCurrent() == nullptr);
+    tlog.flush();
+
+    // Test stopping a group of threads with a deadline
+    gusc::Threads::Thread t21;
+    gusc::Threads::Thread t22(gusc::Threads::QueueType::LockFree);
+    t21.start();
+    t22.start();
+    std::atomic<int> leftoverCounter { 0 };
+    for (auto thread : { &t21, &t22 })
+    {
+        thread->send([](){
+            std::this_thread::sleep_for(50ms);
+        });
+        for (auto i = 0; i < 10; ++i)
+        {
+            thread->send([&leftoverCounter](){
+                ++leftoverCounter;
+            });
+        }
+        thread->sendDelayed([&leftoverCounter](){
+            ++leftoverCounter;
+        }, 1h);
+    }
+    gusc::Threads::ThreadGroup group { &t21, &t22 };
+    auto groupReport = group.shutdown(20ms, gusc::Threads::DelayedMessagePolicy::Return);
+    const auto leftoversRun = leftoverCounter.load();
+    for (auto& delayed : groupReport.delayedMessages)
+    {
+        delayed.message->call();
+    }
+    gusc::Threads::Thread t23;
+    t23.start();
+    std::string drainOrder;
+    t23.sendDelayed([&drainOrder](){
+        drainOrder += "D";
+    }, 1h);
+    t23.send([&drainOrder](){
+        drainOrder += "Q";
+    });
+    t23.stop(gusc::Threads::ShutdownOptions{std::chrono::steady_clock::time_point::max(), gusc::Threads::DelayedMessagePolicy::Run});
+    t23.join();
+    gusc::Threads::Thread t24;
+    t24.start();
+    t24.sendDelayed([](){}, 1h);
+    gusc::Threads::ThreadGroup discardGroup { &t24 };
+    const auto discardReport = discardGroup.shutdown();
+    tlog << "Thread group dropped: " + std::to_string(groupReport.droppedMessages) + ", ran before the deadline: " + std::to_string(leftoversRun)
+        + ", returned delayed: " + std::to_string(groupReport.delayedMessages.size()) + ", returned delayed ran: " + std::to_string(leftoverCounter.load())
+        + ", run policy order: " + drainOrder + ", discarded delayed: " + std::to_string(discardReport.droppedDelayedMessages);
+    tlog.flush();
+
+    // Test priority lanes and starvation protection on all the queue types
+    for (const auto queueType : { gusc::Threads::QueueType::Locking, gusc::Threads::QueueType::LockFree, gusc::Threads::QueueType::Sharded })
+    {
+        gusc::Threads::Thread t10(queueType);
+        std::string priorityOrder;
+        for (const auto& [priority, name] : { std::make_pair(gusc::Threads::Priority::Low, "L"), std::make_pair(gusc::Threads::Priority::Normal, "N"), std::make_pair(gusc::Threads::Priority::High, "H") })
+        {
+            for (auto i = 0; i < 3; ++i)
+            {
+                t10.send([&priorityOrder, name = name](){
+                    priorityOrder += name;
+                }, priority);
+            }
+        }
+        for (auto i = 0; i < 20; ++i)
+        {
+            t10.send([&priorityOrder](){
+                priorityOrder += "h";
+            }, gusc::Threads::Priority::High);
+        }
+        t10.start();
+        t10.stop();
+        t10.join();
+        tlog << "Priority order: " + priorityOrder;
+    }
+    tlog.flush();
+
+    // Test start options
+    gusc::Threads::StartOptions startOptions;
+    startOptions.name = "worker-thread";
+    startOptions.stackSize = 256 * 1024;
+#if defined(__linux__)
+    startOptions.cpuSet = { 0 };
+#endif
+    gusc::Threads::Thread t11;
+    t11.start(startOptions);
+    auto res11 = t11.sendSync<std::string>([]() -> std::string {
+#if defined(__linux__)
+        char name[16] {};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        return std::string(name) + " on CPU " + std::to_string(sched_getcpu());
+#else
+        return "worker-thread";
+#endif
+    });
+    tlog << "Thread started with options: " + res11;
+    gusc::Threads::StartOptions invalidOptions;
+    invalidOptions.numaNode = 4096;
+    gusc::Threads::Thread t12;
+    try
+    {
+        t12.start(invalidOptions);
+        tlog << "Thread started with an invalid NUMA node";
+    }
+    catch (const std::exception& e)
+    {
+        tlog << std::string("Thread start with invalid options failed: ") + e.what();
+    }
+    t12.start();
+    auto res12 = t12.sendSync<bool>([]() -> bool {
+        return true;
+    });
+    tlog << "Thread started after failed start: " + std::to_string(res12);
+    tlog.flush();
+
+    // Test future continuations across threads
+    gusc::Threads::Thread t14;
+    gusc::Threads::Thread t15;
+    t14.start();
+    t15.start();
+    std::promise<std::string> pipelinePromise;
+    auto pipelineFuture = pipelinePromise.get_future();
+    t14.sendFuture<int>([]() -> int {
+        return 20;
+    }).then(&t15, [&t14](int value) -> std::string {
+        return std::to_string(value + 1) + (t14 == std::this_thread::get_id() ? " on the first thread" : " on the second thread");
+    }).then(&t14, [](std::string value) {
+        tlog << "Future continuation: " + value;
+        throw std::runtime_error(value);
+    }).then(&t15, [&pipelinePromise]() {
+        pipelinePromise.set_value("exception was not passed on");
+    });
+    auto failingFuture = t14.sendFuture<int>([]() -> int {
+        throw std::runtime_error("failed on the worker");
+    });
+    try
+    {
+        failingFuture.get();
+    }
+    catch (const std::exception& e)
+    {
+        tlog << std::string("Future exception: ") + e.what();
+    }
+    auto pipelineResult = t15.sendFuture<std::string>([]() -> std::string {
+        return "pipeline";
+    }).then(&t14, [](std::string value) -> std::string {
+        return value + " done";
+    }).get();
+    tlog << "Future pipeline: " + pipelineResult;
+    auto voidFuture = t14.sendFuture<void>([](){});
+    voidFuture.wait();
+    tlog << "Future<void> ready: " + std::to_string(voidFuture.getIsReady());
+    gusc::Threads::Future<int> brokenFuture;
+    {
+        gusc::Threads::Promise<int> brokenPromise;
+        brokenFuture = brokenPromise.getFuture();
+    }
+    try
+    {
+        brokenFuture.get();
+    }
+    catch (const std::future_error& e)
+    {
+        tlog << std::string("Future broken promise: ") + std::to_string(e.code() == std::future_errc::broken_promise);
+    }
+    // Value that fails to be copied into the state is passed on as an exception, a promise left without a value is broken
+    struct ThrowingCopy
+    {
+        ThrowingCopy() = default;
+        ThrowingCopy(const ThrowingCopy&)
+        {
+            throw std::runtime_error("copy failed");
+        }
+        ThrowingCopy(ThrowingCopy&&) noexcept = default;
+    };
+    const ThrowingCopy uncopyable;
+    std::string copyError;
+    try
+    {
+        t14.sendFuture<ThrowingCopy>([&uncopyable]() -> const ThrowingCopy& {
+            return uncopyable;
+        }).get();
+    }
+    catch (const std::exception& e)
+    {
+        copyError = e.what();
+    }
+    gusc::Threads::Future<ThrowingCopy> uncopiedFuture;
+    {
+        gusc::Threads::Promise<ThrowingCopy> uncopiedPromise;
+        uncopiedFuture = uncopiedPromise.getFuture();
+        try
+        {
+            uncopiedPromise.setValue(uncopyable);
+        }
+        catch (const std::exception&)
+        {}
+    }
+    bool isUncopiedBroken { false };
+    try
+    {
+        uncopiedFuture.get();
+    }
+    catch (const std::future_error& e)
+    {
+        isUncopiedBroken = e.code() == std::future_errc::broken_promise;
+    }
+    tlog << "Future value copy failure: " + copyError + ", promise without a value broken: " + std::to_string(isUncopiedBroken);
+    // Only one thread can wait for a future
+    gusc::Threads::Promise<int> waitedPromise;
+    auto waitedFuture = waitedPromise.getFuture();
+    std::atomic<bool> isFirstWaiting { false };
+    auto firstWait = std::async(std::launch::async, [&waitedFuture, &isFirstWaiting](){
+        isFirstWaiting = true;
+        waitedFuture.wait();
+        return waitedFuture.getIsReady();
+    });
+    while (!isFirstWaiting)
+    {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(20ms);
+    t14.sendDelayed([waitedPromise = std::move(waitedPromise)]() mutable {
+        waitedPromise.setValue(7);
+    }, 200ms);
+    bool isSecondWaitRejected { false };
+    try
+    {
+        waitedFuture.wait();
+    }
+    catch (const std::future_error& e)
+    {
+        isSecondWaitRejected = e.code() == std::future_errc::future_already_retrieved;
+    }
+    const auto isFirstWaitReady = firstWait.get();
+    tlog << "Future second wait rejected: " + std::to_string(isSecondWaitRejected) + ", first wait returned ready: "
+        + std::to_string(isFirstWaitReady) + ", value: " + std::to_string(waitedFuture.get());
+    t14.stop();
+    t15.stop();
+    t14.join();
+    t15.join();
+    tlog << "Future exception passed on: " + std::to_string(pipelineFuture.wait_for(0s) != std::future_status::ready);
+    tlog.flush();
+
+#if defined(THREADS_ENABLE_STATISTICS)
+    // Test run-loop statistics
+    gusc::Threads::Thread t13;
+    t13.start();
+    for (auto i = 0; i < 100; ++i)
+    {
+        t13.send([](){
+            std::this_thread::sleep_for(10us);
+        });
+    }
+    t13.sendDelayed([](){}, 10s);
+    t13.sendWait([](){});
+    const auto stats13 = t13.getStatistics();
+    tlog << "Statistics queued: " + std::to_string(stats13.messagesQueued)
+        + ", executed: " + std::to_string(stats13.messagesExecuted)
+        + ", delayed: " + std::to_string(stats13.delayedQueueLength)
+        + ", sampled: " + std::to_string(stats13.executionTime.count)
+        + ", execution p50: " + std::to_string(stats13.executionTime.getPercentile(0.5).count()) + "ns"
+        + ", latency p99: " + std::to_string(stats13.enqueueLatency.getPercentile(0.99).count()) + "ns";
+    t13.stop();
+    t13.join();
+    tlog.flush();
+#endif
+
+#if defined(THREADS_HAS_EVENT_WAIT)
+    // Test file descriptor watching with the event wait backend
+    gusc::Threads::ThreadOptions eventOptions;
+    eventOptions.queueType = gusc::Threads::QueueType::LockFree;
+    eventOptions.waitBackend = gusc::Threads::WaitBackendType::Event;
+    gusc::Threads::Thread t17(eventOptions);
+    t17.start();
+    int pipeFds[2] { -1, -1 };
+    if (pipe(pipeFds) == 0)
+    {
+        std::promise<std::string> readPromise;
+        auto readFuture = readPromise.get_future();
+        std::string received;
+        t17.watch(pipeFds[0], gusc::Threads::IoEvents::Read, [&t17, &received, &readPromise, fd = pipeFds[0]](gusc::Threads::IoEvents){
+            char buffer[16] {};
+            const auto size = read(fd, buffer, sizeof(buffer));
+            received.append(buffer, static_cast<std::size_t>(std::max<ssize_t>(size, 0)));
+            if (received.size() >= 4)
+            {
+                t17.unwatch(fd);
+                readPromise.set_value(received + " on the thread: " + std::to_string(t17 == std::this_thread::get_id()));
+            }
+        });
+        // Delayed messages and file descriptors share the same wait
+        auto delayedPromise = std::make_shared<std::promise<void>>();
+        auto delayedFuture = delayedPromise->get_future();
+        t17.sendDelayed([delayedPromise](){
+            delayedPromise->set_value();
+        }, 20ms);
+        [[maybe_unused]] const auto written1 = write(pipeFds[1], "pi", 2);
+        std::this_thread::sleep_for(10ms);
+        [[maybe_unused]] const auto written2 = write(pipeFds[1], "pe", 2);
+        tlog << "Watched file descriptor read: " + readFuture.get() + ", delayed message: "
+            + std::to_string(delayedFuture.wait_for(1s) == std::future_status::ready);
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+    }
+    // Watching a descriptor again replaces the callback in place and a failed re-watch keeps the previous watch
+    int rewatchFds[2] { -1, -1 };
+    if (pipe(rewatchFds) == 0)
+    {
+        std::atomic<int> replacedCalls { 0 };
+        std::promise<void> rewatchPromise;
+        auto rewatchFuture = rewatchPromise.get_future();
+        t17.watch(rewatchFds[0], gusc::Threads::IoEvents::Read, [&replacedCalls](gusc::Threads::IoEvents){
+            ++replacedCalls;
+        });
+        t17.watch(rewatchFds[0], gusc::Threads::IoEvents::Read, [&rewatchPromise, fd = rewatchFds[0], isSet = false](gusc::Threads::IoEvents) mutable {
+            char buffer[16] {};
+            [[maybe_unused]] const auto size = read(fd, buffer, sizeof(buffer));
+            if (!std::exchange(isSet, true))
+            {
+                rewatchPromise.set_value();
+            }
+        });
+        [[maybe_unused]] const auto written = write(rewatchFds[1], "re", 2);
+        const auto isReplaced = rewatchFuture.wait_for(1s) == std::future_status::ready;
+        // Re-watching a closed descriptor fails
+        close(rewatchFds[0]);
+        bool isRewatchFailed { false };
+        try
+        {
+            t17.watch(rewatchFds[0], gusc::Threads::IoEvents::Read, [](gusc::Threads::IoEvents){});
+        }
+        catch (const std::exception&)
+        {
+            isRewatchFailed = true;
+        }
+        const auto isPreviousKept = t17.unwatch(rewatchFds[0]);
+        close(rewatchFds[1]);
+        tlog << "Re-watched descriptor called the new callback: " + std::to_string(isReplaced) + ", previous callback calls: "
+            + std::to_string(replacedCalls.load()) + ", failed re-watch reported: " + std::to_string(isRewatchFailed)
+            + ", previous watch kept: " + std::to_string(isPreviousKept);
+    }
+    // Spinning run-loop ends the spin for ready descriptors and due delayed messages, each readiness is dispatched once
+    for (const auto queueType : {gusc::Threads::QueueType::Locking, gusc::Threads::QueueType::LockFree})
+    {
+        gusc::Threads::ThreadOptions spinningEventOptions;
+        spinningEventOptions.queueType = queueType;
+        spinningEventOptions.waitBackend = gusc::Threads::WaitBackendType::Event;
+        spinningEventOptions.spinCycles = 1000;
+        gusc::Threads::Thread t25(spinningEventOptions);
+        t25.start();
+        int spinFds[2] { -1, -1 };
+        if (pipe(spinFds) == 0 && fcntl(spinFds[0], F_SETFL, O_NONBLOCK) == 0)
+        {
+            std::atomic<int> reads { 0 };
+            std::atomic<int> emptyReads { 0 };
+            t25.watch(spinFds[0], gusc::Threads::IoEvents::Read, [&reads, &emptyReads, fd = spinFds[0]](gusc::Threads::IoEvents){
+                char buffer[16] {};
+                if (read(fd, buffer, sizeof(buffer)) > 0)
+                {
+                    ++reads;
+                }
+                else
+                {
+                    ++emptyReads;
+                }
+            });
+            int delayedRuns { 0 };
+            for (auto i = 0; i < 20; ++i)
+            {
+                [[maybe_unused]] const auto written = write(spinFds[1], "s", 1);
+                const auto deadline = std::chrono::steady_clock::now() + 1s;
+                while (reads.load() <= i && std::chrono::steady_clock::now() < deadline)
+                {
+                    std::this_thread::yield();
+                }
+                auto delayedPromise = std::make_shared<std::promise<void>>();
+                auto delayedFuture = delayedPromise->get_future();
+                t25.sendDelayed([delayedPromise](){
+                    delayedPromise->set_value();
+                }, 1ms);
+                delayedRuns += (delayedFuture.wait_for(1s) == std::future_status::ready);
+            }
+            t25.unwatch(spinFds[0]);
+            tlog << "Spinning event run-loop queue: " + std::to_string(static_cast<int>(queueType)) + ", descriptor reads: "
+                + std::to_string(reads.load()) + ", empty reads: " + std::to_string(emptyReads.load())
+                + ", delayed messages: " + std::to_string(delayedRuns);
+        }
+        close(spinFds[0]);
+        close(spinFds[1]);
+    }
+    try
+    {
+        gusc::Threads::Thread t18;
+        t18.watch(0, gusc::Threads::IoEvents::Read, [](gusc::Threads::IoEvents){});
+    }
+    catch (const std::exception& e)
+    {
+        tlog << std::string("Watching with the condition variable backend: ") + e.what();
+    }
+    tlog.flush();
+#endif
+
     mt.start();
     std::this_thread::sleep_for(3s);
 }
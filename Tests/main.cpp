@@ -6,11 +6,15 @@
 //  Copyright © 2020 Gusts Kaksis. All rights reserved.
 //
 
+#include "CoroutineTests.hpp"
 #include "ThreadTests.hpp"
 #include "SignalTests.hpp"
+#include "ThreadPoolTests.hpp"
 
 int main(int argc, const char * argv[]) {
     runThreadTests();
     runSignalTests();
+    runThreadPoolTests();
+    runCoroutineTests();
     return 0;
 }
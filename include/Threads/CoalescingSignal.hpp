@@ -0,0 +1,217 @@
+//
+//  CoalescingSignal.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef CoalescingSignal_hpp
+#define CoalescingSignal_hpp
+
+#include "Signal.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gusc::Threads
+{
+
+/// @brief signal for state updates where listeners only care about the latest value (i.e. position or progress)
+/// Every listener host has a single pending slot. An emission copies it's arguments over the ones waiting in the slot and a message
+/// is only posted to the host when the slot was empty (no message is posted per emission), so a slow listener receives the latest
+/// arguments once instead of a backlog of all the emissions in between.
+/// @note listeners on the emitting thread and Direct listeners are called on every emission, BlockingQueued listeners are not
+/// coalesced as the emitter waits for them anyway
+/// @note coalesced arguments are delivered to the listeners that were connected when the message was posted - a listener connected
+/// while a message is pending gets it's first call with the next message
+/// @note Signal is a private base, so the emissions can't bypass coalescing through a Signal reference
+template<typename ...TArg>
+class CoalescingSignal : private Signal<TArg...>
+{
+    using Base = Signal<TArg...>;
+    using SlotList = typename Base::SlotList;
+    using SlotKey = typename Base::SlotKey;
+    using SlotKeyHash = typename Base::SlotKeyHash;
+    using Payload = typename Base::Payload;
+    using SharedSignalMessage = typename Base::SharedSignalMessage;
+
+    /// @brief latest arguments waiting for a listener host, it's only non-empty while a message to the host is posted
+    struct PendingSlot
+    {
+        std::mutex mutex;
+        std::optional<Payload> payload;
+        /// @brief trace of the emission the waiting arguments came from
+        EmissionTrace trace;
+        
+        /// @brief replace the waiting arguments
+        /// @return true if the slot was empty and a new message must be posted
+        inline bool store(const EmissionTrace& newTrace, const TArg&... data)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto isEmpty = !payload.has_value();
+            // Arguments are constructed in place as they don't have to be assignable
+            payload.reset();
+            payload.emplace(data...);
+            trace = newTrace;
+            return isEmpty;
+        }
+        
+        /// @brief take the waiting arguments out, emissions from now on post a new message
+        /// @param takenTrace - set to the trace of the emission the arguments came from
+        inline std::optional<Payload> take(EmissionTrace& takenTrace)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::optional<Payload> data;
+            if (payload)
+            {
+                data.emplace(std::move(*payload));
+                payload.reset();
+                takenTrace = trace;
+            }
+            return data;
+        }
+    };
+
+    /// @brief pending slots of the host groups of one slot list (in the order of the groups)
+    struct PendingSlots
+    {
+        std::shared_ptr<const SlotList> slotList;
+        std::vector<std::shared_ptr<PendingSlot>> slots;
+    };
+
+    /// @brief internal class representing a message that calls the listeners of one host with the latest arguments of it's pending
+    /// slot
+    class CoalescedSignalMessage
+    {
+    public:
+        CoalescedSignalMessage(const std::shared_ptr<const SlotList>& initSlots, std::size_t initHostIndex, const std::shared_ptr<PendingSlot>& initPending)
+            : slots(initSlots)
+            , hostIndex(initHostIndex)
+            , pending(initPending)
+        {}
+        CoalescedSignalMessage(const CoalescedSignalMessage&) = delete;
+        CoalescedSignalMessage& operator=(const CoalescedSignalMessage&) = delete;
+        CoalescedSignalMessage(CoalescedSignalMessage&&) = default;
+        CoalescedSignalMessage& operator=(CoalescedSignalMessage&&) = default;
+        ~CoalescedSignalMessage()
+        {
+            if (pending)
+            {
+                // Message was dropped without being called, let the next emission post a new one
+                EmissionTrace trace;
+                pending->take(trace);
+            }
+        }
+        inline void operator()()
+        {
+            EmissionTrace trace;
+            const auto data = std::exchange(pending, nullptr)->take(trace);
+            if (data)
+            {
+                Base::callHost(*slots, hostIndex, *data, trace);
+            }
+        }
+    private:
+        std::shared_ptr<const SlotList> slots;
+        std::size_t hostIndex { 0 };
+        std::shared_ptr<PendingSlot> pending;
+    };
+
+public:
+    CoalescingSignal() = default;
+    
+    using Base::connect;
+    using Base::disconnect;
+
+    /// @brief emit the signal to all of it's listeners, replacing the arguments that are still waiting for the listeners on other
+    /// threads
+    /// @param data - signal arguments
+    /// @throws the first exception thrown while delivering the emission, same as Signal::emit
+    inline void emit(const TArg&... data)
+    {
+        const auto trace = this->noteEmitted();
+        std::exception_ptr error;
+        std::shared_ptr<const Payload> payload;
+        std::shared_ptr<const PendingSlots> pendingSlots;
+        const auto snapshot = this->getSnapshot();
+        for (std::size_t hostIndex = 0; hostIndex < snapshot->hosts.size(); ++hostIndex)
+        {
+            if (Base::getIsCalledInline(*snapshot, hostIndex))
+            {
+                Base::callHostInline(*snapshot, hostIndex, std::forward_as_tuple(data...), trace, error);
+                continue;
+            }
+            if (snapshot->hosts[hostIndex].type == ConnectionType::BlockingQueued)
+            {
+                if (!payload)
+                {
+                    payload = std::make_shared<const Payload>(data...);
+                }
+                Base::sendHost(*snapshot, hostIndex, SharedSignalMessage{snapshot, hostIndex, trace, payload}, error);
+                continue;
+            }
+            if (!pendingSlots)
+            {
+                pendingSlots = getPendingSlots(snapshot);
+            }
+            const auto& pending = pendingSlots->slots[hostIndex];
+            if (pending->store(trace, data...))
+            {
+                // Slot was empty - no message is waiting for the host
+                Base::sendHost(*snapshot, hostIndex, CoalescedSignalMessage{snapshot, hostIndex, pending}, error);
+            }
+        }
+        Base::rethrowError(error);
+    }
+
+private:
+    /// @brief pending slots of the last emitted slot list
+    std::shared_ptr<const PendingSlots> pendingSlots { std::make_shared<const PendingSlots>() };
+    /// @brief pending slots of the host groups, kept when the slot list is republished so that a host never has two messages posted
+    std::unordered_map<SlotKey, std::shared_ptr<PendingSlot>, SlotKeyHash> hostSlots;
+    /// @brief guards the pending slots of the slot list
+    std::mutex pendingMutex;
+
+    /// @brief get the pending slots of a slot list, building them the first time the slot list is emitted
+    std::shared_ptr<const PendingSlots> getPendingSlots(const std::shared_ptr<const SlotList>& slotList)
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        if (pendingSlots->slotList != slotList)
+        {
+            auto newPendingSlots = std::make_shared<PendingSlots>();
+            newPendingSlots->slotList = slotList;
+            newPendingSlots->slots.reserve(slotList->hosts.size());
+            std::unordered_map<SlotKey, std::shared_ptr<PendingSlot>, SlotKeyHash> newHostSlots;
+            for (const auto& group : slotList->hosts)
+            {
+                const auto key = slotList->slots[group.slots.front()].getHostKey();
+                const auto it = hostSlots.find(key);
+                auto pending = (it != hostSlots.end()) ? it->second : std::make_shared<PendingSlot>();
+                newHostSlots.emplace(key, pending);
+                newPendingSlots->slots.push_back(std::move(pending));
+            }
+            // Slots of the hosts that are gone are released here (or by their last message)
+            hostSlots = std::move(newHostSlots);
+            pendingSlots = std::move(newPendingSlots);
+        }
+        return pendingSlots;
+    }
+};
+
+/// @brief specialization for coalescing signals without arguments
+template<>
+class CoalescingSignal<void> : public CoalescingSignal<>
+{
+};
+
+}
+
+#endif /* CoalescingSignal_hpp */
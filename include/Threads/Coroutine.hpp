@@ -0,0 +1,352 @@
+//
+//  Coroutine.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef Coroutine_hpp
+#define Coroutine_hpp
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#   if __has_include(<coroutine>)
+#       define THREADS_HAS_COROUTINES 1
+#   endif
+#endif
+
+#if defined(THREADS_HAS_COROUTINES)
+
+#include "CoalescingSignal.hpp"
+#include "Future.hpp"
+#include "Signal.hpp"
+#include "Thread.hpp"
+#include "ThreadPool.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace gusc::Threads
+{
+
+/// @brief fire-and-forget coroutine type
+/// The coroutine starts running right away on the calling thread and it's frame is destroyed when it finishes.
+/// @note an exception escaping the coroutine calls std::terminate (same as with std::thread)
+class Task
+{
+public:
+    struct promise_type
+    {
+        inline Task get_return_object() noexcept
+        {
+            return {};
+        }
+        inline std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+        inline std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+        inline void return_void() noexcept
+        {}
+        inline void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+/// @brief message callable that owns a suspended coroutine until the message is called
+/// A message that is destroyed without being called (i.e. dropped by a full bounded queue or by a shutdown deadline) resumes the
+/// coroutine with std::future_error (broken_promise) on the destroying thread, so the coroutine frame is never leaked.
+class ResumeMessage
+{
+public:
+    /// @brief coroutine that is being suspended on the calling thread, it's messages dropped while sending are only marked as dropped
+    struct Sending
+    {
+        std::coroutine_handle<> handle;
+        bool isDropped { false };
+    };
+
+    ResumeMessage(std::coroutine_handle<> initHandle, std::exception_ptr& initError) noexcept
+        : handle(initHandle)
+        , error(&initError)
+    {}
+    ResumeMessage(const ResumeMessage&) = delete;
+    ResumeMessage& operator=(const ResumeMessage&) = delete;
+    ResumeMessage(ResumeMessage&& other) noexcept
+        : handle(std::exchange(other.handle, nullptr))
+        , error(other.error)
+    {}
+    ResumeMessage& operator=(ResumeMessage&&) = delete;
+    ~ResumeMessage()
+    {
+        if (!handle)
+        {
+            return;
+        }
+        *error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+        auto sending = getSending();
+        if (sending && sending->handle == handle)
+        {
+            // Coroutine has not finished suspending yet, the awaiter resumes it instead
+            sending->isDropped = true;
+        }
+        else
+        {
+            handle.resume();
+        }
+    }
+
+    inline void operator()()
+    {
+        std::exchange(handle, nullptr).resume();
+    }
+
+    /// @brief give up the ownership of the coroutine without resuming it
+    inline void release() noexcept
+    {
+        handle = nullptr;
+    }
+
+    /// @return coroutine that is being suspended on the calling thread (nullptr if there is none)
+    static inline Sending*& getSending() noexcept
+    {
+        thread_local Sending* sending { nullptr };
+        return sending;
+    }
+
+private:
+    std::coroutine_handle<> handle;
+    std::exception_ptr* error { nullptr };
+};
+
+/// @brief awaiter that resumes the coroutine on the run-loop of a Thread or on a worker of a ThreadPool
+/// @note the coroutine is always resumed through the message queue, so awaiting the current thread lets other messages run first
+/// @note if the message is dropped without being called the coroutine is resumed with std::future_error (broken_promise) - right
+/// away if the host drops it while sending, otherwise on the thread that drops it
+template<typename THost>
+class HostAwaiter
+{
+public:
+    explicit HostAwaiter(THost& initHost) noexcept
+        : host(initHost)
+    {}
+
+    inline bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    /// @throws std::runtime_error if the host is not accepting messages (the coroutine is resumed with the exception)
+    inline bool await_suspend(std::coroutine_handle<> handle)
+    {
+        ResumeMessage message{handle, error};
+        ResumeMessage::Sending sending{handle};
+        auto& currentSending = ResumeMessage::getSending();
+        const auto outerSending = std::exchange(currentSending, &sending);
+        try
+        {
+            host.send(std::move(message));
+        }
+        catch (...)
+        {
+            currentSending = outerSending;
+            // If the message was never made the coroutine is still owned here, it's resumed with the exception by the caller
+            message.release();
+            throw;
+        }
+        currentSending = outerSending;
+        // Unless the message has been dropped the coroutine may be resumed on the host before this returns, so the awaiter must not
+        // be touched
+        return !sending.isDropped;
+    }
+
+    inline void await_resume() const
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    THost& host;
+    std::exception_ptr error;
+};
+
+/// @brief co_await thread - resume the coroutine on the thread's run-loop
+inline HostAwaiter<Thread> operator co_await(Thread& thread) noexcept
+{
+    return HostAwaiter<Thread>(thread);
+}
+
+/// @brief co_await pool - resume the coroutine on one of the pool's workers
+inline HostAwaiter<ThreadPool> operator co_await(ThreadPool& pool) noexcept
+{
+    return HostAwaiter<ThreadPool>(pool);
+}
+
+/// @brief awaiter that suspends the coroutine until a Future is ready
+/// @note the coroutine is resumed on the thread that fulfilled the future (the coroutine doesn't suspend if the future is already ready),
+/// co_await a Thread afterwards to continue on a specific thread
+template<typename TValue>
+class FutureAwaiter
+{
+public:
+    explicit FutureAwaiter(Future<TValue>&& initFuture) noexcept
+        : future(std::move(initFuture))
+    {}
+
+    inline bool await_ready() const noexcept
+    {
+        return future.getIsReady();
+    }
+
+    inline bool await_suspend(std::coroutine_handle<> handle)
+    {
+        auto resume = [handle](){
+            handle.resume();
+        };
+        std::unique_ptr<Message> continuation = std::make_unique<CallableMessage<decltype(resume)>>(std::move(resume));
+        // The coroutine may be resumed on another thread before this returns, so the awaiter must not be touched after this call
+        return future.getState().setContinuationIfPending(continuation);
+    }
+
+    inline TValue await_resume()
+    {
+        return future.get();
+    }
+
+private:
+    Future<TValue> future;
+};
+
+/// @brief co_await future - suspend until the value is available
+template<typename TValue>
+inline FutureAwaiter<TValue> operator co_await(Future<TValue>&& future) noexcept
+{
+    return FutureAwaiter<TValue>(std::move(future));
+}
+
+/// @brief co_await future - suspend until the value is available (the future is consumed)
+template<typename TValue>
+inline FutureAwaiter<TValue> operator co_await(Future<TValue>& future) noexcept
+{
+    return FutureAwaiter<TValue>(std::move(future));
+}
+
+/// @brief awaiter that suspends the coroutine until the next emission of a signal
+/// A one-shot listener is connected to the signal when the coroutine suspends and disconnected when the signal is emitted.
+/// The coroutine is resumed on the host of the listener with the emitted arguments - nothing for Signal<>, the argument for a single
+/// argument signal, a std::tuple of the arguments otherwise.
+/// @note TSignal is Signal<TArg...> or CoalescingSignal<TArg...>
+template<typename THost, typename TSignal, typename ...TArg>
+class SignalAwaiter
+{
+public:
+    SignalAwaiter(TSignal& initSignal, THost* initHost)
+        : signal(initSignal)
+        , host(initHost)
+        , state(std::make_shared<State>())
+    {}
+
+    inline bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // The coroutine may be resumed on the host before this returns, so only local copies are used after connecting
+        auto currentState = state;
+        auto currentSignal = &signal;
+        currentState->handle = handle;
+        std::lock_guard<std::mutex> lock(currentState->mutex);
+        currentState->connectionId = signal.connect(host, [currentState, currentSignal](const TArg&... args){
+            std::size_t connectionId { 0 };
+            {
+                // Wait for connect to return the connection ID
+                std::lock_guard<std::mutex> lock(currentState->mutex);
+                if (currentState->isFired)
+                {
+                    return;
+                }
+                currentState->isFired = true;
+                currentState->payload.emplace(args...);
+                connectionId = currentState->connectionId;
+            }
+            currentSignal->disconnect(connectionId);
+            currentState->handle.resume();
+        });
+    }
+
+    auto await_resume()
+    {
+        if constexpr (sizeof...(TArg) == 1)
+        {
+            return std::get<0>(std::move(*state->payload));
+        }
+        else if constexpr (sizeof...(TArg) > 1)
+        {
+            return std::move(*state->payload);
+        }
+    }
+
+private:
+    struct State
+    {
+        std::mutex mutex;
+        std::size_t connectionId { 0 };
+        bool isFired { false };
+        std::optional<std::tuple<TArg...>> payload;
+        std::coroutine_handle<> handle;
+    };
+
+    TSignal& signal;
+    THost* host { nullptr };
+    std::shared_ptr<State> state;
+};
+
+/// @brief co_await nextEmission(signal, &thread) - suspend until the signal is emitted and resume on the thread with the arguments
+template<typename THost, typename ...TArg>
+inline SignalAwaiter<THost, Signal<TArg...>, TArg...> nextEmission(Signal<TArg...>& signal, THost* host)
+{
+    return SignalAwaiter<THost, Signal<TArg...>, TArg...>(signal, host);
+}
+
+/// @brief co_await nextEmission(signal, &thread) - suspend until the signal without arguments is emitted and resume on the thread
+template<typename THost>
+inline SignalAwaiter<THost, Signal<void>> nextEmission(Signal<void>& signal, THost* host)
+{
+    return SignalAwaiter<THost, Signal<void>>(signal, host);
+}
+
+/// @brief co_await nextEmission(signal, &thread) - suspend until the coalescing signal is emitted and resume on the thread with the arguments
+template<typename THost, typename ...TArg>
+inline SignalAwaiter<THost, CoalescingSignal<TArg...>, TArg...> nextEmission(CoalescingSignal<TArg...>& signal, THost* host)
+{
+    return SignalAwaiter<THost, CoalescingSignal<TArg...>, TArg...>(signal, host);
+}
+
+/// @brief co_await nextEmission(signal, &thread) - suspend until the coalescing signal without arguments is emitted and resume on the thread
+template<typename THost>
+inline SignalAwaiter<THost, CoalescingSignal<void>> nextEmission(CoalescingSignal<void>& signal, THost* host)
+{
+    return SignalAwaiter<THost, CoalescingSignal<void>>(signal, host);
+}
+
+}
+
+#endif
+
+#endif /* Coroutine_hpp */
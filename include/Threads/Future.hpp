@@ -0,0 +1,457 @@
+//
+//  Future.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef Future_hpp
+#define Future_hpp
+
+#include "Message.hpp"
+#include "MessagePool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace gusc::Threads
+{
+
+template<typename TValue>
+class Future;
+
+template<typename TValue>
+class Promise;
+
+template<typename TValue>
+class FutureAwaiter;
+
+/// @brief reference counted state shared by a Promise and a Future
+/// The state is allocated from the MessagePool and the value and the continuation are handed over with a single atomic status, so
+/// neither fulfilling nor attaching a continuation takes a lock.
+template<typename TValue>
+class FutureState
+{
+public:
+    static inline void* operator new(std::size_t size)
+    {
+        return MessagePool::allocate(size);
+    }
+    static inline void operator delete(void* ptr, std::size_t size) noexcept
+    {
+        MessagePool::deallocate(ptr, size);
+    }
+
+    inline void addRef() noexcept
+    {
+        refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void release() noexcept
+    {
+        if (refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    /// @brief store the value without making the state ready
+    /// @note if constructing the value throws the state stays pending
+    template<typename ...TArgs>
+    void storeValue(TArgs&&... args)
+    {
+        value.emplace(std::forward<TArgs>(args)...);
+    }
+
+    /// @brief store the exception without making the state ready
+    void storeException(std::exception_ptr newException) noexcept
+    {
+        exception = std::move(newException);
+    }
+
+    inline bool getIsReady() const noexcept
+    {
+        return status.load(std::memory_order_acquire) == Status::Ready;
+    }
+
+    /// @brief make the state ready, calling the continuation if it has been set
+    /// @warning the value or the exception must be stored first and the state can be made ready only once
+    void setReady()
+    {
+        auto expected = Status::Empty;
+        while (!status.compare_exchange_weak(expected, Status::Ready, std::memory_order_acq_rel))
+        {
+            if (expected == Status::HasContinuation)
+            {
+                // Continuation was set first, it's called here on the fulfilling thread
+                std::unique_ptr<Message> next(continuation);
+                continuation = nullptr;
+                status.store(Status::Ready, std::memory_order_release);
+                next->call();
+                return;
+            }
+            if (expected == Status::Ready)
+            {
+                return;
+            }
+            // Another thread is in the middle of publishing the continuation
+            std::this_thread::yield();
+            expected = Status::Empty;
+        }
+    }
+
+    /// @brief set a message that is called as soon as the state is ready (right away if it already is)
+    /// @throws std::future_error (future_already_retrieved) if a continuation has already been set
+    void setContinuation(std::unique_ptr<Message> newContinuation)
+    {
+        if (!setContinuationIfPending(newContinuation))
+        {
+            // Value is already here
+            newContinuation->call();
+        }
+    }
+
+    /// @brief set a message that is called on the fulfilling thread as soon as the state is ready
+    /// @param newContinuation - continuation, ownership is passed to the state only if it's stored
+    /// @return false if the state is already ready and the continuation was not stored
+    /// @throws std::future_error (future_already_retrieved) if a continuation has already been set
+    bool setContinuationIfPending(std::unique_ptr<Message>& newContinuation)
+    {
+        auto expected = Status::Empty;
+        // Continuation is written only by the thread that has claimed the state, the fulfilling thread waits until it's published
+        if (status.compare_exchange_strong(expected, Status::SettingContinuation, std::memory_order_acquire))
+        {
+            continuation = newContinuation.release();
+            status.store(Status::HasContinuation, std::memory_order_release);
+            return true;
+        }
+        if (expected != Status::Ready)
+        {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+        return false;
+    }
+
+    /// @brief block until the state is ready
+    /// @throws std::future_error (future_already_retrieved) if a continuation has already been set (i.e. another thread is waiting)
+    void wait()
+    {
+        if (getIsReady())
+        {
+            return;
+        }
+        struct Waiter
+        {
+            std::mutex mutex;
+            std::condition_variable wait;
+            bool isDone { false };
+        } waiter;
+        auto notify = [&waiter](){
+            std::lock_guard<std::mutex> lock(waiter.mutex);
+            waiter.isDone = true;
+            waiter.wait.notify_one();
+        };
+        setContinuation(std::make_unique<CallableMessage<decltype(notify)>>(std::move(notify)));
+        std::unique_lock<std::mutex> lock(waiter.mutex);
+        waiter.wait.wait(lock, [&waiter](){
+            return waiter.isDone;
+        });
+    }
+
+    /// @brief move the value out of a ready state or re-throw the exception
+    TValue take()
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+        if constexpr (!std::is_void_v<TValue>)
+        {
+            return std::move(*value);
+        }
+    }
+
+private:
+    enum class Status : std::uint8_t
+    {
+        Empty,
+        SettingContinuation,
+        HasContinuation,
+        Ready
+    };
+    using Storage = std::conditional_t<std::is_void_v<TValue>, bool, TValue>;
+
+    std::atomic<std::size_t> refCount { 1 };
+    std::atomic<Status> status { Status::Empty };
+    std::optional<Storage> value;
+    std::exception_ptr exception;
+    Message* continuation { nullptr };
+};
+
+/// @brief result of an asynchronous operation that can be waited for or continued on another thread
+/// Unlike std::future it does not need a std::promise allocation (the shared state comes from the MessagePool) and a continuation
+/// can be attached with then(), so multi-hop pipelines don't need to block any of the threads.
+/// @note a future can be consumed only once - by get() or by then()
+template<typename TValue>
+class Future
+{
+public:
+    Future() = default;
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+    Future(Future&& other) noexcept
+        : state(other.state)
+    {
+        other.state = nullptr;
+    }
+    Future& operator=(Future&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            state = other.state;
+            other.state = nullptr;
+        }
+        return *this;
+    }
+    ~Future()
+    {
+        reset();
+    }
+
+    /// @return true if the future has a shared state (it has not been consumed)
+    inline bool getIsValid() const noexcept
+    {
+        return state != nullptr;
+    }
+
+    /// @return true if the value (or an exception) is available
+    inline bool getIsReady() const noexcept
+    {
+        return state && state->getIsReady();
+    }
+
+    /// @brief block the calling thread until the value is available
+    /// @throws std::future_error (future_already_retrieved) if another thread is already waiting for the same future
+    void wait() const
+    {
+        getState().wait();
+    }
+
+    /// @brief block the calling thread until the value is available and return it
+    /// @throws the exception of the asynchronous operation
+    TValue get()
+    {
+        auto& currentState = getState();
+        currentState.wait();
+        // Keep the state alive until the value has been moved out
+        Future consumed(std::move(*this));
+        return currentState.take();
+    }
+
+    /// @brief call a callback on a thread once the value is available
+    /// @param thread - thread (or any other object with a send() method, i.e. ThreadPool) the callback is sent to
+    /// @param callback - callable that takes the value (or nothing for Future<void>), if the future holds an exception the callback is
+    /// not called and the exception is passed on to the returned future
+    /// @return future of the callback's result
+    template<typename THost, typename TCallable>
+    auto then(THost* thread, TCallable&& callback)
+    {
+        using TResult = typename ResultOf<std::decay_t<TCallable>>::type;
+        auto& currentState = getState();
+        Promise<TResult> promise;
+        auto future = promise.getFuture();
+        auto post = [source = std::move(*this), thread, callback = std::forward<TCallable>(callback), promise = std::move(promise)]() mutable {
+            try
+            {
+                thread->send([source = std::move(source), callback = std::move(callback), promise = std::move(promise)]() mutable {
+                    promise.fulfill([&source, &callback]() {
+                        if constexpr (std::is_void_v<TValue>)
+                        {
+                            source.get();
+                            return callback();
+                        }
+                        else
+                        {
+                            return callback(source.get());
+                        }
+                    });
+                });
+            }
+            catch (...)
+            {
+                // Thread is not accepting messages - the promise is broken when it's destroyed
+            }
+        };
+        currentState.setContinuation(std::make_unique<CallableMessage<decltype(post)>>(std::move(post)));
+        return future;
+    }
+
+private:
+    friend class Promise<TValue>;
+    template<typename TFutureValue>
+    friend class FutureAwaiter;
+
+    template<typename TCallable, typename TArg = TValue>
+    struct ResultOf
+    {
+        using type = std::invoke_result_t<TCallable, TArg>;
+    };
+    template<typename TCallable>
+    struct ResultOf<TCallable, void>
+    {
+        using type = std::invoke_result_t<TCallable>;
+    };
+
+    FutureState<TValue>* state { nullptr };
+
+    explicit Future(FutureState<TValue>* initState) noexcept
+        : state(initState)
+    {
+        state->addRef();
+    }
+
+    inline FutureState<TValue>& getState() const
+    {
+        if (!state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return *state;
+    }
+
+    inline void reset() noexcept
+    {
+        if (state)
+        {
+            state->release();
+            state = nullptr;
+        }
+    }
+};
+
+/// @brief producer side of a Future
+/// @note if a promise is destroyed without setting a value the future receives std::future_error with broken_promise
+template<typename TValue>
+class Promise
+{
+public:
+    Promise()
+        : state(new FutureState<TValue>())
+    {}
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+    Promise(Promise&& other) noexcept
+        : state(other.state)
+        , isSatisfied(other.isSatisfied)
+        , isFutureRetrieved(other.isFutureRetrieved)
+    {
+        other.state = nullptr;
+    }
+    Promise& operator=(Promise&&) = delete;
+    ~Promise()
+    {
+        if (state)
+        {
+            if (!isSatisfied)
+            {
+                state->storeException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+                state->setReady();
+            }
+            state->release();
+        }
+    }
+
+    /// @note future can be retrieved only once
+    Future<TValue> getFuture()
+    {
+        if (!state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        if (isFutureRetrieved)
+        {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+        isFutureRetrieved = true;
+        return Future<TValue>(state);
+    }
+
+    /// @throws the exception thrown by the value's constructor (the promise is not satisfied then)
+    template<typename ...TArgs>
+    void setValue(TArgs&&... args)
+    {
+        auto& currentState = getState();
+        currentState.storeValue(std::forward<TArgs>(args)...);
+        // Promise is satisfied only once the value is stored, but before the continuation runs, as it may throw
+        isSatisfied = true;
+        currentState.setReady();
+    }
+
+    void setException(std::exception_ptr exception)
+    {
+        auto& currentState = getState();
+        currentState.storeException(std::move(exception));
+        isSatisfied = true;
+        currentState.setReady();
+    }
+
+    /// @brief call a callable and set it's result (or the exception it threw) as the value
+    template<typename TCallable>
+    void fulfill(TCallable&& callable)
+    {
+        try
+        {
+            if constexpr (std::is_void_v<TValue>)
+            {
+                callable();
+                setValue();
+            }
+            else
+            {
+                setValue(callable());
+            }
+        }
+        catch (...)
+        {
+            if (!isSatisfied)
+            {
+                setException(std::current_exception());
+            }
+        }
+    }
+
+private:
+    FutureState<TValue>* state { nullptr };
+    bool isSatisfied { false };
+    bool isFutureRetrieved { false };
+
+    inline FutureState<TValue>& getState()
+    {
+        if (!state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        if (isSatisfied)
+        {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+        return *state;
+    }
+};
+
+}
+
+#endif /* Future_hpp */
@@ -0,0 +1,171 @@
+//
+//  IntrusiveQueue.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef IntrusiveQueue_hpp
+#define IntrusiveQueue_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace gusc::Threads
+{
+
+/// @brief intrusive single-threaded FIFO queue that links nodes through their own next pointer (no allocations)
+/// @note TNode must have a virtual destructor and a public std::atomic<TNode*> next member (shared with MpscQueue)
+/// @note queue owns the nodes pushed on it - any nodes left in the queue are deleted on destruction
+template<typename TNode>
+class IntrusiveQueue
+{
+public:
+    IntrusiveQueue() = default;
+    IntrusiveQueue(const IntrusiveQueue&) = delete;
+    IntrusiveQueue& operator=(const IntrusiveQueue&) = delete;
+    IntrusiveQueue(IntrusiveQueue&& other) noexcept
+        : first(other.first)
+        , last(other.last)
+        , count(other.count)
+    {
+        other.first = nullptr;
+        other.last = nullptr;
+        other.count = 0;
+    }
+    IntrusiveQueue& operator=(IntrusiveQueue&&) = delete;
+    ~IntrusiveQueue()
+    {
+        while (auto node = pop())
+        {
+            delete node;
+        }
+    }
+
+    /// @brief push a node at the back of the queue
+    /// @param node - node to push, ownership is passed to the queue
+    inline void push(TNode* node) noexcept
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        if (last)
+        {
+            last->next.store(node, std::memory_order_relaxed);
+        }
+        else
+        {
+            first = node;
+        }
+        last = node;
+        ++count;
+    }
+
+    /// @brief pop a node from the front of the queue
+    /// @return node or nullptr if queue is empty, ownership is passed to the caller
+    inline TNode* pop() noexcept
+    {
+        TNode* const node = first;
+        if (node)
+        {
+            first = node->next.load(std::memory_order_relaxed);
+            if (!first)
+            {
+                last = nullptr;
+            }
+            --count;
+        }
+        return node;
+    }
+
+    /// @brief move all the nodes of other queue to the back of this queue
+    inline void splice(IntrusiveQueue& other) noexcept
+    {
+        if (other.first)
+        {
+            if (last)
+            {
+                last->next.store(other.first, std::memory_order_relaxed);
+            }
+            else
+            {
+                first = other.first;
+            }
+            last = other.last;
+            count += other.count;
+            other.first = nullptr;
+            other.last = nullptr;
+            other.count = 0;
+        }
+    }
+
+    /// @brief move up to count nodes from the front of other queue to the back of this queue
+    inline void splice(IntrusiveQueue& other, std::size_t spliceCount) noexcept
+    {
+        if (spliceCount >= other.count)
+        {
+            splice(other);
+            return;
+        }
+        if (spliceCount == 0)
+        {
+            return;
+        }
+        // Find the last node that is moved
+        TNode* cut = other.first;
+        for (std::size_t i = 1; i < spliceCount; ++i)
+        {
+            cut = cut->next.load(std::memory_order_relaxed);
+        }
+        TNode* const rest = cut->next.load(std::memory_order_relaxed);
+        cut->next.store(nullptr, std::memory_order_relaxed);
+        if (last)
+        {
+            last->next.store(other.first, std::memory_order_relaxed);
+        }
+        else
+        {
+            first = other.first;
+        }
+        last = cut;
+        count += spliceCount;
+        other.first = rest;
+        other.count -= spliceCount;
+    }
+
+    /// @brief give up the ownership of all the nodes, nodes stay linked through their next pointers
+    /// @return first and last node of the chain or a pair of nullptr if queue is empty
+    inline std::pair<TNode*, TNode*> release() noexcept
+    {
+        const auto chain = std::make_pair(first, last);
+        first = nullptr;
+        last = nullptr;
+        count = 0;
+        return chain;
+    }
+
+    /// @return first node of the queue or nullptr if queue is empty, ownership stays with the queue
+    inline TNode* front() const noexcept
+    {
+        return first;
+    }
+
+    inline bool empty() const noexcept
+    {
+        return first == nullptr;
+    }
+
+    inline std::size_t size() const noexcept
+    {
+        return count;
+    }
+
+private:
+    TNode* first { nullptr };
+    TNode* last { nullptr };
+    std::size_t count { 0 };
+};
+
+}
+
+#endif /* IntrusiveQueue_hpp */
@@ -0,0 +1,127 @@
+//
+//  Message.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef Message_hpp
+#define Message_hpp
+
+#include "MessagePool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace gusc::Threads
+{
+
+/// @brief base class for a message placed on a thread's message queue
+/// @note all the messages are allocated from the MessagePool, so small messages occupy a single cache line
+class Message
+{
+public:
+    virtual ~Message() = default;
+    virtual void call() {}
+    
+    static inline void* operator new(std::size_t size)
+    {
+        return MessagePool::allocate(size);
+    }
+    static inline void* operator new(std::size_t size, std::align_val_t alignment)
+    {
+        if (size <= MessagePool::MaxBlockSize)
+        {
+            // Pool blocks are aligned to their size, which is never less than the alignment of the type
+            return MessagePool::allocate(size);
+        }
+        return ::operator new(size, alignment);
+    }
+    static inline void operator delete(void* ptr, std::size_t size) noexcept
+    {
+        MessagePool::deallocate(ptr, size);
+    }
+    static inline void operator delete(void* ptr, std::size_t size, std::align_val_t alignment) noexcept
+    {
+        if (size <= MessagePool::MaxBlockSize)
+        {
+            MessagePool::deallocate(ptr, size);
+        }
+        else
+        {
+            ::operator delete(ptr, size, alignment);
+        }
+    }
+    
+    /// @brief intrusive link used by the message queues
+    std::atomic<Message*> next { nullptr };
+#if defined(THREADS_ENABLE_STATISTICS)
+    /// @brief time the message was placed on the queue, only set on messages sampled for statistics
+    std::chrono::steady_clock::time_point enqueueTime {};
+#endif
+#if defined(THREADS_ENABLE_TRACING)
+    /// @brief ID connecting the trace events of the message, set when the message is placed on the queue
+    std::uint64_t traceId { 0 };
+#endif
+};
+
+/// @brief templated message to wrap a callable object
+template<typename TCallable>
+class CallableMessage : public Message
+{
+public:
+    template<typename TInitCallable>
+    explicit CallableMessage(TInitCallable&& initCallableObject)
+        : callableObject(std::forward<TInitCallable>(initCallableObject))
+    {}
+    void call() override
+    {
+        callableObject();
+    }
+private:
+    TCallable callableObject;
+};
+
+/// @brief templated message to wrap a callable object which accepts promise object that can be used to signal finish of the callable (useful for subsequent async calls)
+template<typename TReturn, typename TCallable>
+class CallableMessageWithPromise : public Message
+{
+public:
+    template<typename TInitCallable>
+    CallableMessageWithPromise(TInitCallable&& initCallableObject, std::promise<TReturn> initWaitablePromise)
+        : callableObject(std::forward<TInitCallable>(initCallableObject))
+        , waitablePromise(std::move(initWaitablePromise))
+    {}
+    void call() override
+    {
+        actualCall<TReturn>();
+    }
+private:
+    TCallable callableObject;
+    std::promise<TReturn> waitablePromise;
+    
+    template<typename TR>
+    void actualCall()
+    {
+        if constexpr (std::is_void_v<TR>)
+        {
+            callableObject();
+            waitablePromise.set_value();
+        }
+        else
+        {
+            waitablePromise.set_value(callableObject());
+        }
+    }
+};
+
+}
+
+#endif /* Message_hpp */
@@ -0,0 +1,272 @@
+//
+//  MessagePool.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef MessagePool_hpp
+#define MessagePool_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace gusc::Threads
+{
+
+/// @brief assumed size of a CPU cache line
+/// @note used instead of std::hardware_destructive_interference_size, which is missing on some standard libraries and depends on the
+/// compiler's tuning flags, so it's not safe to use in the layout of header-only classes
+constexpr const std::size_t CacheLineSize { 64 };
+
+/// @brief slab allocator for thread messages
+/// Memory is handed out in power of two size classes starting with one cache line. Every OS thread allocates from it's own
+/// cache of slabs without any locking, blocks released on other threads are returned to the owner through a lock-free list.
+/// Slabs are never given back to the system, so once the pool has warmed up sending messages does not call malloc at all.
+/// Caches of exited threads are handed over to new threads together with their slabs.
+class MessagePool
+{
+    static constexpr const std::size_t SizeClassCount { 5 };
+    static constexpr const std::size_t SlabSize { 64 * 1024 };
+
+public:
+    /// @brief size of the largest block served by the pool, anything bigger goes to the global allocator
+    static constexpr const std::size_t MaxBlockSize { CacheLineSize << (SizeClassCount - 1) };
+
+    /// @brief allocate a block of memory that is aligned to the smallest power of two that fits the size
+    static inline void* allocate(std::size_t size)
+    {
+        const auto sizeClass = getSizeClass(size);
+        if (sizeClass == SizeClassCount)
+        {
+            return ::operator new(size);
+        }
+        Cache* const cache = getCache();
+        if (!cache)
+        {
+            // Thread is exiting and it's cache is already gone - use an ownerless slab for a single block
+            return reinterpret_cast<char*>(allocateSlab(nullptr)) + MaxBlockSize;
+        }
+        return cache->allocate(sizeClass);
+    }
+
+    /// @brief return a block of memory to the pool
+    /// @param ptr - pointer returned by allocate()
+    /// @param size - the same size that was passed to allocate()
+    static inline void deallocate(void* ptr, std::size_t size) noexcept
+    {
+        const auto sizeClass = getSizeClass(size);
+        if (sizeClass == SizeClassCount)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        Slab* const slab = reinterpret_cast<Slab*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(SlabSize - 1));
+        if (!slab->owner)
+        {
+            // Block was allocated while the thread was exiting
+            slab->~Slab();
+            ::operator delete(slab, std::align_val_t(SlabSize));
+            return;
+        }
+        auto block = static_cast<Block*>(ptr);
+        if (slab->owner == currentCache())
+        {
+            slab->owner->localFree[sizeClass].push(block);
+        }
+        else
+        {
+            slab->owner->remoteFree[sizeClass].push(block);
+        }
+    }
+
+private:
+    struct Cache;
+
+    /// @brief slab header, blocks of a slab are found by masking their address
+    struct alignas(CacheLineSize) Slab
+    {
+        Cache* owner { nullptr };
+    };
+
+    struct Block
+    {
+        Block* next { nullptr };
+    };
+
+    /// @brief free list used only by the owner thread
+    struct LocalList
+    {
+        Block* first { nullptr };
+
+        inline void push(Block* block) noexcept
+        {
+            block->next = first;
+            first = block;
+        }
+
+        inline Block* pop() noexcept
+        {
+            Block* const block = first;
+            if (block)
+            {
+                first = block->next;
+            }
+            return block;
+        }
+    };
+
+    /// @brief free list where other threads push and only the owner takes all of the blocks at once (so there's no ABA problem)
+    struct RemoteList
+    {
+        std::atomic<Block*> first { nullptr };
+
+        inline void push(Block* block) noexcept
+        {
+            block->next = first.load(std::memory_order_relaxed);
+            while (!first.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+            {}
+        }
+
+        inline Block* takeAll() noexcept
+        {
+            if (first.load(std::memory_order_relaxed))
+            {
+                return first.exchange(nullptr, std::memory_order_acquire);
+            }
+            return nullptr;
+        }
+    };
+
+    /// @brief per thread set of free lists and slabs for all size classes
+    struct Cache
+    {
+        LocalList localFree[SizeClassCount];
+        RemoteList remoteFree[SizeClassCount];
+        char* slabNext[SizeClassCount] {};
+        char* slabEnd[SizeClassCount] {};
+        Cache* nextAbandoned { nullptr };
+
+        inline void* allocate(std::size_t sizeClass)
+        {
+            if (auto block = localFree[sizeClass].pop())
+            {
+                return block;
+            }
+            if (auto block = remoteFree[sizeClass].takeAll())
+            {
+                localFree[sizeClass].first = block->next;
+                return block;
+            }
+            const auto blockSize = CacheLineSize << sizeClass;
+            if (slabNext[sizeClass] == slabEnd[sizeClass])
+            {
+                auto slab = allocateSlab(this);
+                // First block is taken by the slab header
+                slabNext[sizeClass] = reinterpret_cast<char*>(slab) + blockSize;
+                slabEnd[sizeClass] = reinterpret_cast<char*>(slab) + SlabSize;
+            }
+            void* const block = slabNext[sizeClass];
+            slabNext[sizeClass] += blockSize;
+            return block;
+        }
+    };
+
+    /// @brief releases the cache of an exiting thread so that a new thread can adopt it
+    struct CacheGuard
+    {
+        ~CacheGuard()
+        {
+            abandonCache(currentCache());
+            currentCache() = nullptr;
+            getIsExited() = true;
+        }
+    };
+
+    static inline Slab* allocateSlab(Cache* owner)
+    {
+        auto slab = new (::operator new(SlabSize, std::align_val_t(SlabSize))) Slab();
+        slab->owner = owner;
+        return slab;
+    }
+
+    static constexpr inline std::size_t getSizeClass(std::size_t size) noexcept
+    {
+        std::size_t sizeClass { 0 };
+        while (sizeClass < SizeClassCount && (CacheLineSize << sizeClass) < size)
+        {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    static inline Cache*& currentCache() noexcept
+    {
+        thread_local Cache* cache { nullptr };
+        return cache;
+    }
+
+    static inline bool& getIsExited() noexcept
+    {
+        thread_local bool isExited { false };
+        return isExited;
+    }
+
+    static inline Cache* getCache()
+    {
+        auto& cache = currentCache();
+        if (!cache && !getIsExited())
+        {
+            cache = adoptCache();
+            thread_local CacheGuard guard;
+        }
+        return cache;
+    }
+
+    static inline std::mutex& getAbandonedMutex() noexcept
+    {
+        static std::mutex abandonedMutex;
+        return abandonedMutex;
+    }
+
+    static inline Cache*& getAbandoned() noexcept
+    {
+        static Cache* abandoned { nullptr };
+        return abandoned;
+    }
+
+    static inline Cache* adoptCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(getAbandonedMutex());
+            auto& abandoned = getAbandoned();
+            if (abandoned)
+            {
+                Cache* const cache = abandoned;
+                abandoned = cache->nextAbandoned;
+                cache->nextAbandoned = nullptr;
+                return cache;
+            }
+        }
+        return new Cache();
+    }
+
+    static inline void abandonCache(Cache* cache) noexcept
+    {
+        if (cache)
+        {
+            std::lock_guard<std::mutex> lock(getAbandonedMutex());
+            auto& abandoned = getAbandoned();
+            cache->nextAbandoned = abandoned;
+            abandoned = cache;
+        }
+    }
+};
+
+}
+
+#endif /* MessagePool_hpp */
@@ -0,0 +1,110 @@
+//
+//  MpscQueue.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef MpscQueue_hpp
+#define MpscQueue_hpp
+
+#include "MessagePool.hpp"
+
+#include <atomic>
+
+namespace gusc::Threads
+{
+
+/// @brief intrusive lock-free multi-producer/single-consumer queue (based on Dmitry Vyukov's non-blocking MPSC queue)
+/// @note TNode must be default constructible, have a virtual destructor and a public std::atomic<TNode*> next member
+/// @note queue owns the nodes pushed on it - any nodes left in the queue are deleted on destruction
+template<typename TNode>
+class MpscQueue
+{
+public:
+    MpscQueue() = default;
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+    ~MpscQueue()
+    {
+        while (!empty())
+        {
+            delete pop();
+        }
+    }
+
+    /// @brief push a node on the queue, can be called from any thread
+    /// @param node - node to push, ownership is passed to the queue
+    inline void push(TNode* node) noexcept
+    {
+        push(node, node);
+    }
+
+    /// @brief push a chain of already linked nodes on the queue, can be called from any thread
+    /// @param first - first node of the chain
+    /// @param last - last node of the chain (the next pointer of this node will be reset)
+    inline void push(TNode* first, TNode* last) noexcept
+    {
+        last->next.store(nullptr, std::memory_order_relaxed);
+        TNode* const prev = head.exchange(last);
+        prev->next.store(first, std::memory_order_release);
+    }
+
+    /// @brief pop a node from the queue
+    /// @warning must only be called from the consumer thread
+    /// @return node or nullptr if queue is empty or a producer has not finished linking it's node yet (check empty() to distinguish)
+    inline TNode* pop() noexcept
+    {
+        TNode* current = tail;
+        TNode* next = current->next.load(std::memory_order_acquire);
+        if (current == &stub)
+        {
+            if (!next)
+            {
+                return nullptr;
+            }
+            tail = next;
+            current = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next)
+        {
+            tail = next;
+            return current;
+        }
+        if (current != head.load())
+        {
+            // Producer has exchanged the head, but has not linked it yet
+            return nullptr;
+        }
+        // Last node in the queue - put the stub behind it so that the node can be released
+        push(&stub);
+        next = current->next.load(std::memory_order_acquire);
+        if (next)
+        {
+            tail = next;
+            return current;
+        }
+        return nullptr;
+    }
+
+    /// @brief check if there are no nodes in the queue (including nodes that are still being pushed)
+    /// @warning must only be called from the consumer thread
+    inline bool empty() const noexcept
+    {
+        return tail == &stub && head.load() == &stub;
+    }
+
+private:
+    TNode stub;
+    /// @brief written by the producers, kept on a separate cache line from the consumer's end
+    alignas(CacheLineSize) std::atomic<TNode*> head { &stub };
+    alignas(CacheLineSize) TNode* tail { &stub };
+};
+
+}
+
+#endif /* MpscQueue_hpp */
@@ -0,0 +1,361 @@
+//
+//  NativeThread.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef NativeThread_hpp
+#define NativeThread_hpp
+
+#include <thread>
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#   include <limits.h>
+#   include <pthread.h>
+#   include <sched.h>
+#   include <sys/resource.h>
+#   include <unistd.h>
+#endif
+#if defined(__linux__)
+#   include <sys/syscall.h>
+#endif
+
+namespace gusc::Threads
+{
+
+/// @brief scheduling policy of a thread
+enum class SchedulingPolicy
+{
+    /// @brief default time-sharing scheduling, StartOptions::niceValue adjusts the priority
+    Default,
+    /// @brief real-time first-in first-out scheduling (requires privileges), StartOptions::schedulingPriority sets the priority
+    Fifo,
+    /// @brief real-time round-robin scheduling (requires privileges), StartOptions::schedulingPriority sets the priority
+    RoundRobin
+};
+
+/// @brief options applied to a thread when it's started
+/// @note CPU set and NUMA node are only supported on Linux, names are supported on Linux and macOS, an exception is thrown if a
+/// requested option is not supported or can not be applied
+struct StartOptions
+{
+    /// @brief CPUs the thread is allowed to run on (empty - any CPU or CPUs of numaNode)
+    std::vector<std::size_t> cpuSet;
+    /// @brief NUMA node the thread prefers to allocate memory from (-1 - no preference), if cpuSet is empty the thread is also pinned to the CPUs of this node
+    int numaNode { -1 };
+    SchedulingPolicy schedulingPolicy { SchedulingPolicy::Default };
+    /// @brief real-time priority used with SchedulingPolicy::Fifo and SchedulingPolicy::RoundRobin
+    int schedulingPriority { 0 };
+    /// @brief nice value used with SchedulingPolicy::Default (0 - leave as is)
+    /// @note only supported on Linux, where nice values are per thread - other systems (i.e. macOS, FreeBSD) only have a nice value
+    /// for the whole process, so starting a thread with a non-zero value throws there
+    int niceValue { 0 };
+    /// @brief thread name shown in debuggers and system tools (empty - leave as is, Linux truncates names to 15 characters)
+    std::string name;
+    /// @brief stack size in bytes (0 - system default)
+    std::size_t stackSize { 0 };
+};
+
+/// @brief thread handle that can be created with StartOptions
+/// On POSIX systems the thread is created with pthread_create so that the stack size can be set, everywhere else std::thread is used.
+/// Start options are applied on the new thread before the callable is called - the constructor waits for that and re-throws any errors.
+class NativeThread
+{
+public:
+#if defined(__unix__) || defined(__APPLE__)
+    using NativeHandle = pthread_t;
+#else
+    using NativeHandle = std::thread::native_handle_type;
+#endif
+
+    /// @param options - options to apply to the new thread
+    /// @param callable - callable object to run on the new thread
+    template<typename TCallable>
+    NativeThread(const StartOptions& options, TCallable&& callable)
+    {
+        auto context = std::make_unique<Context<std::decay_t<TCallable>>>(options, std::forward<TCallable>(callable));
+        auto idFuture = context->idPromise.get_future();
+#if defined(__unix__) || defined(__APPLE__)
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+        if (options.stackSize)
+        {
+            pthread_attr_setstacksize(&attributes, std::max<std::size_t>(options.stackSize, PTHREAD_STACK_MIN));
+        }
+        const auto result = pthread_create(&handle, &attributes, &Context<std::decay_t<TCallable>>::run, context.get());
+        pthread_attr_destroy(&attributes);
+        if (result != 0)
+        {
+            throw std::runtime_error("Failed to create a thread");
+        }
+        context.release();
+        isJoinable = true;
+#else
+        thread = std::thread(&Context<std::decay_t<TCallable>>::run, context.release());
+        handle = thread.native_handle();
+#endif
+        try
+        {
+            id = idFuture.get();
+        }
+        catch (...)
+        {
+            // Thread has finished without calling the callable
+            join();
+            throw;
+        }
+    }
+    NativeThread(const NativeThread&) = delete;
+    NativeThread& operator=(const NativeThread&) = delete;
+    NativeThread(NativeThread&&) = delete;
+    NativeThread& operator=(NativeThread&&) = delete;
+    ~NativeThread()
+    {
+        join();
+    }
+
+    inline std::thread::id get_id() const noexcept
+    {
+        return id;
+    }
+
+    inline bool joinable() const noexcept
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        return isJoinable;
+#else
+        return thread.joinable();
+#endif
+    }
+
+    inline void join()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (isJoinable)
+        {
+            pthread_join(handle, nullptr);
+            isJoinable = false;
+        }
+#else
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+#endif
+    }
+
+    inline NativeHandle native_handle() const noexcept
+    {
+        return handle;
+    }
+
+    /// @brief apply start options to the calling thread
+    static void applyToCurrentThread(const StartOptions& options)
+    {
+        if (!options.name.empty())
+        {
+            setName(options.name);
+        }
+        auto cpuSet = options.cpuSet;
+        if (options.numaNode >= 0)
+        {
+            setPreferredNumaNode(options.numaNode);
+            if (cpuSet.empty())
+            {
+                cpuSet = getNumaNodeCpus(options.numaNode);
+            }
+        }
+        if (!cpuSet.empty())
+        {
+            setAffinity(cpuSet);
+        }
+        setScheduling(options);
+    }
+
+private:
+    /// @brief everything the new thread needs, owned by the new thread once it has been created
+    template<typename TCallable>
+    struct Context
+    {
+        template<typename TInitCallable>
+        Context(const StartOptions& initOptions, TInitCallable&& initCallable)
+            : options(initOptions)
+            , callable(std::forward<TInitCallable>(initCallable))
+        {}
+
+        StartOptions options;
+        TCallable callable;
+        std::promise<std::thread::id> idPromise;
+
+        static void* run(void* arg)
+        {
+            std::unique_ptr<Context> context(static_cast<Context*>(arg));
+            try
+            {
+                applyToCurrentThread(context->options);
+            }
+            catch (...)
+            {
+                context->idPromise.set_exception(std::current_exception());
+                return nullptr;
+            }
+            context->idPromise.set_value(std::this_thread::get_id());
+            context->callable();
+            return nullptr;
+        }
+    };
+
+    NativeHandle handle {};
+    std::thread::id id;
+#if defined(__unix__) || defined(__APPLE__)
+    bool isJoinable { false };
+#else
+    std::thread thread;
+#endif
+
+    static void setName(const std::string& name)
+    {
+#if defined(__linux__)
+        // Linux limits thread names to 16 bytes including the terminating zero
+        if (pthread_setname_np(pthread_self(), name.substr(0, 15).c_str()) != 0)
+        {
+            throw std::runtime_error("Failed to set the thread name");
+        }
+#elif defined(__APPLE__)
+        if (pthread_setname_np(name.c_str()) != 0)
+        {
+            throw std::runtime_error("Failed to set the thread name");
+        }
+#else
+        throw std::runtime_error("Thread names are not supported on this platform");
+#endif
+    }
+
+    static void setAffinity(const std::vector<std::size_t>& cpuSet)
+    {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const auto cpu : cpuSet)
+        {
+            if (cpu >= CPU_SETSIZE)
+            {
+                throw std::runtime_error("CPU index is out of range");
+            }
+            CPU_SET(cpu, &set);
+        }
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+        {
+            throw std::runtime_error("Failed to set the thread CPU affinity");
+        }
+#else
+        (void)cpuSet;
+        throw std::runtime_error("Thread CPU affinity is not supported on this platform");
+#endif
+    }
+
+    /// @brief read the list of CPUs that belong to a NUMA node
+    static std::vector<std::size_t> getNumaNodeCpus(int numaNode)
+    {
+#if defined(__linux__)
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist");
+        std::string cpuList;
+        if (!file || !std::getline(file, cpuList))
+        {
+            throw std::runtime_error("Failed to read the CPU list of NUMA node " + std::to_string(numaNode));
+        }
+        // The list looks like 0-3,8-11
+        std::vector<std::size_t> cpus;
+        std::istringstream stream(cpuList);
+        std::string range;
+        while (std::getline(stream, range, ','))
+        {
+            const auto dash = range.find('-');
+            const auto first = std::stoul(range.substr(0, dash));
+            const auto last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+            for (auto cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+#else
+        (void)numaNode;
+        throw std::runtime_error("NUMA nodes are not supported on this platform");
+#endif
+    }
+
+    /// @brief make the kernel allocate memory for the calling thread on a NUMA node (falling back to other nodes if it's full)
+    static void setPreferredNumaNode(int numaNode)
+    {
+#if defined(__linux__)
+        // MPOL_PREFERRED from linux/mempolicy.h, the system call is used directly so that libnuma is not required
+        constexpr const int PreferredPolicy { 1 };
+        constexpr const std::size_t MaskBits { sizeof(unsigned long) * 8 };
+        std::vector<unsigned long> nodeMask(static_cast<std::size_t>(numaNode) / MaskBits + 1, 0);
+        nodeMask[static_cast<std::size_t>(numaNode) / MaskBits] |= 1UL << (static_cast<std::size_t>(numaNode) % MaskBits);
+        if (syscall(SYS_set_mempolicy, PreferredPolicy, nodeMask.data(), nodeMask.size() * MaskBits + 1) != 0)
+        {
+            throw std::runtime_error("Failed to set the NUMA memory policy");
+        }
+#else
+        (void)numaNode;
+        throw std::runtime_error("NUMA nodes are not supported on this platform");
+#endif
+    }
+
+    static void setScheduling(const StartOptions& options)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (options.schedulingPolicy == SchedulingPolicy::Default)
+        {
+            if (options.niceValue != 0)
+            {
+#   if defined(__linux__)
+                // On Linux nice values are per thread
+                const auto target = static_cast<id_t>(syscall(SYS_gettid));
+                if (setpriority(PRIO_PROCESS, target, options.niceValue) != 0)
+                {
+                    throw std::runtime_error("Failed to set the thread nice value");
+                }
+#   else
+                // Elsewhere the nice value belongs to the whole process
+                throw std::runtime_error("Thread nice values are not supported on this platform");
+#   endif
+            }
+        }
+        else
+        {
+            sched_param parameters {};
+            parameters.sched_priority = options.schedulingPriority;
+            const auto policy = options.schedulingPolicy == SchedulingPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+            if (pthread_setschedparam(pthread_self(), policy, &parameters) != 0)
+            {
+                throw std::runtime_error("Failed to set the thread scheduling policy");
+            }
+        }
+#else
+        if (options.schedulingPolicy != SchedulingPolicy::Default || options.niceValue != 0)
+        {
+            throw std::runtime_error("Thread scheduling options are not supported on this platform");
+        }
+#endif
+    }
+};
+
+}
+
+#endif /* NativeThread_hpp */
@@ -0,0 +1,133 @@
+//
+//  PriorityLanes.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef PriorityLanes_hpp
+#define PriorityLanes_hpp
+
+#include <array>
+#include <cstddef>
+
+namespace gusc::Threads
+{
+
+/// @brief priority of a message
+enum class Priority
+{
+    Low,
+    Normal,
+    High
+};
+
+/// @brief number of message priority levels
+constexpr const std::size_t PriorityCount { 3 };
+
+/// @brief set of queues, one per priority level, popped in priority order
+/// Higher priority lanes are always popped first, but a lower priority lane that has been passed over StarvationLimit times in a row
+/// gets one node popped, so a steady stream of high priority nodes can't starve the rest of the lanes.
+/// @note TQueue must have push(), pop() and empty() methods (IntrusiveQueue, MpscQueue or RingQueue)
+/// @note pushing can be done on the individual lanes from any thread that is allowed to push on TQueue, popping must only be done from the consumer thread
+template<typename TQueue>
+class PriorityLanes
+{
+public:
+    /// @brief maximum number of times in a row a non-empty lane is passed over in favour of a higher priority lane
+    static constexpr const std::size_t StarvationLimit { 16 };
+
+    PriorityLanes() = default;
+    /// @param laneArg - argument passed to the constructor of every lane
+    template<typename TLaneArg>
+    explicit PriorityLanes(const TLaneArg& laneArg)
+        : lanes{{TQueue(laneArg), TQueue(laneArg), TQueue(laneArg)}}
+    {}
+    PriorityLanes(const PriorityLanes&) = delete;
+    PriorityLanes& operator=(const PriorityLanes&) = delete;
+    PriorityLanes(PriorityLanes&&) = delete;
+    PriorityLanes& operator=(PriorityLanes&&) = delete;
+
+    inline TQueue& operator[](Priority priority) noexcept
+    {
+        return lanes[static_cast<std::size_t>(priority)];
+    }
+
+    inline const TQueue& operator[](Priority priority) const noexcept
+    {
+        return lanes[static_cast<std::size_t>(priority)];
+    }
+
+    /// @brief pop a node from the highest priority lane unless a lower priority lane is starving
+    /// @return node or nullptr if the selected lane did not return one, ownership is passed to the caller
+    inline auto pop() noexcept
+    {
+        auto lane = selectLane();
+        return lane ? lane->pop() : nullptr;
+    }
+
+    /// @brief move all the nodes of other lanes to the back of the matching lanes of this set
+    inline void splice(PriorityLanes& other) noexcept
+    {
+        for (std::size_t i = 0; i < PriorityCount; ++i)
+        {
+            lanes[i].splice(other.lanes[i]);
+        }
+    }
+
+    /// @return true if all the lanes are empty
+    inline bool empty() const noexcept
+    {
+        for (const auto& lane : lanes)
+        {
+            if (!lane.empty())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static_assert(static_cast<std::size_t>(Priority::High) + 1 == PriorityCount, "Priority levels do not match PriorityCount");
+
+    std::array<TQueue, PriorityCount> lanes;
+    /// @brief number of times in a row every lane has been passed over while it was not empty
+    std::array<std::size_t, PriorityCount> skipCounts {};
+
+    inline TQueue* selectLane() noexcept
+    {
+        auto top = PriorityCount;
+        while (top > 0 && lanes[top - 1].empty())
+        {
+            --top;
+        }
+        if (top == 0)
+        {
+            return nullptr;
+        }
+        --top;
+        for (auto i = top; i > 0; --i)
+        {
+            if (skipCounts[i - 1] >= StarvationLimit && !lanes[i - 1].empty())
+            {
+                skipCounts[i - 1] = 0;
+                return &lanes[i - 1];
+            }
+        }
+        for (std::size_t i = 0; i < top; ++i)
+        {
+            if (!lanes[i].empty())
+            {
+                ++skipCounts[i];
+            }
+        }
+        skipCounts[top] = 0;
+        return &lanes[top];
+    }
+};
+
+}
+
+#endif /* PriorityLanes_hpp */
@@ -0,0 +1,124 @@
+//
+//  RingQueue.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef RingQueue_hpp
+#define RingQueue_hpp
+
+#include <cstddef>
+#include <vector>
+
+namespace gusc::Threads
+{
+
+/// @brief single-threaded fixed capacity FIFO queue of node pointers backed by a preallocated ring buffer
+/// @note TNode must have a virtual destructor
+/// @note queue owns the nodes pushed on it - any nodes left in the queue are deleted on destruction
+template<typename TNode>
+class RingQueue
+{
+public:
+    /// @param initCapacity - maximum number of nodes in the queue (0 - queue is disabled and always full)
+    explicit RingQueue(std::size_t initCapacity = 0)
+        : nodes(initCapacity, nullptr)
+    {}
+    RingQueue(const RingQueue&) = delete;
+    RingQueue& operator=(const RingQueue&) = delete;
+    RingQueue(RingQueue&&) = delete;
+    RingQueue& operator=(RingQueue&&) = delete;
+    ~RingQueue()
+    {
+        while (auto node = pop())
+        {
+            delete node;
+        }
+    }
+
+    /// @brief push a node at the back of the queue
+    /// @param node - node to push, ownership is passed to the queue only if the push succeeds
+    /// @return false if the queue is full
+    inline bool push(TNode* node) noexcept
+    {
+        if (full())
+        {
+            return false;
+        }
+        auto index = first + count;
+        if (index >= nodes.size())
+        {
+            index -= nodes.size();
+        }
+        nodes[index] = node;
+        ++count;
+        return true;
+    }
+
+    /// @brief pop a node from the front of the queue
+    /// @return node or nullptr if queue is empty, ownership is passed to the caller
+    inline TNode* pop() noexcept
+    {
+        if (empty())
+        {
+            return nullptr;
+        }
+        TNode* const node = nodes[first];
+        nodes[first] = nullptr;
+        if (++first == nodes.size())
+        {
+            first = 0;
+        }
+        --count;
+        return node;
+    }
+
+    inline bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    inline bool full() const noexcept
+    {
+        return count == nodes.size();
+    }
+
+    inline std::size_t size() const noexcept
+    {
+        return count;
+    }
+
+    inline std::size_t getCapacity() const noexcept
+    {
+        return nodes.size();
+    }
+
+    /// @brief move the ring buffer to a freshly allocated memory block keeping the node order
+    /// Used to place the buffer on the memory of the calling thread after it has changed its memory policy.
+    inline void reallocate()
+    {
+        std::vector<TNode*> newNodes(nodes.size(), nullptr);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto index = first + i;
+            if (index >= nodes.size())
+            {
+                index -= nodes.size();
+            }
+            newNodes[i] = nodes[index];
+        }
+        nodes.swap(newNodes);
+        first = 0;
+    }
+
+private:
+    std::vector<TNode*> nodes;
+    std::size_t first { 0 };
+    std::size_t count { 0 };
+};
+
+}
+
+#endif /* RingQueue_hpp */
@@ -0,0 +1,216 @@
+//
+//  ShardedQueue.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef ShardedQueue_hpp
+#define ShardedQueue_hpp
+
+#include "MessagePool.hpp"
+#include "MpscQueue.hpp"
+#include "PriorityLanes.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace gusc::Threads
+{
+
+/// @brief intrusive multi-producer/single-consumer queue with a separate shard for every producer thread
+/// Every producer thread gets it's own set of priority lanes the first time it pushes a node, so producers never write to the same cache
+/// line and each shard has a single producer. The consumer drains all the shards in turn.
+/// @note nodes of one producer stay in order, there is no order between nodes of different producers
+template<typename TNode>
+class ShardedQueue
+{
+public:
+    using Lanes = PriorityLanes<MpscQueue<TNode>>;
+
+    ShardedQueue() = default;
+    ShardedQueue(const ShardedQueue&) = delete;
+    ShardedQueue& operator=(const ShardedQueue&) = delete;
+    ShardedQueue(ShardedQueue&&) = delete;
+    ShardedQueue& operator=(ShardedQueue&&) = delete;
+    ~ShardedQueue()
+    {
+        std::lock_guard<std::mutex> lock(shardMutex);
+        for (const auto& shard : shards)
+        {
+            // Producers drop their reference the next time they register a shard
+            shard->hasConsumer.store(false, std::memory_order_release);
+        }
+    }
+
+    /// @brief get the lanes of the calling thread's shard, the shard is registered on the first call from every thread
+    /// @note any thread can push nodes on the returned lanes, but only the calling thread may do it
+    inline Lanes& getLocalLanes()
+    {
+        auto& registry = getRegistry();
+        if (registry.lastId == id)
+        {
+            return registry.lastShard->lanes;
+        }
+        Shard* shard { nullptr };
+        const auto it = registry.shards.find(id);
+        if (it != registry.shards.end())
+        {
+            shard = it->second.get();
+        }
+        else
+        {
+            shard = registerShard(registry);
+        }
+        registry.lastId = id;
+        registry.lastShard = shard;
+        return shard->lanes;
+    }
+
+    /// @brief move all the nodes that are available in the shards to the back of the matching lanes of the target
+    /// @warning must only be called from the consumer thread
+    template<typename TLanes>
+    void drain(TLanes& target)
+    {
+        refreshShards();
+        for (std::size_t i = 0; i < activeShards.size();)
+        {
+            auto& shard = *activeShards[i];
+            // Producer flag is read first, so that the last nodes of a producer that has finished are not missed
+            const auto hasProducer = shard.hasProducer.load(std::memory_order_acquire);
+            for (const auto priority : { Priority::High, Priority::Normal, Priority::Low })
+            {
+                auto& lane = shard.lanes[priority];
+                while (auto node = lane.pop())
+                {
+                    target[priority].push(node);
+                }
+            }
+            if (!hasProducer && shard.lanes.empty())
+            {
+                removeShard(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    /// @brief check if there are no nodes in any of the shards (including nodes that are still being pushed)
+    /// @warning must only be called from the consumer thread
+    bool empty()
+    {
+        refreshShards();
+        for (const auto& shard : activeShards)
+        {
+            if (!shard->lanes.empty())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct alignas(CacheLineSize) Shard
+    {
+        Lanes lanes;
+        /// @brief cleared when the producer thread exits, the consumer removes the shard once it's empty
+        std::atomic<bool> hasProducer { true };
+        /// @brief cleared when the queue is destroyed, the producer removes the shard from it's registry
+        std::atomic<bool> hasConsumer { true };
+    };
+
+    /// @brief shards of all the queues the calling thread has pushed to
+    struct Registry
+    {
+        std::uint64_t lastId { 0 };
+        Shard* lastShard { nullptr };
+        std::unordered_map<std::uint64_t, std::shared_ptr<Shard>> shards;
+
+        ~Registry()
+        {
+            for (const auto& shard : shards)
+            {
+                shard.second->hasProducer.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    /// @brief queue IDs are never reused, so a registry can not mistake a new queue for a destroyed one at the same address
+    static inline std::atomic<std::uint64_t> nextId { 1 };
+
+    const std::uint64_t id { nextId.fetch_add(1, std::memory_order_relaxed) };
+    /// @brief all the registered shards, only accessed while holding shardMutex
+    std::vector<std::shared_ptr<Shard>> shards;
+    /// @brief consumer's copy of the shards
+    std::vector<std::shared_ptr<Shard>> activeShards;
+    /// @brief set by producers when a shard has been registered since the consumer last copied the shards
+    std::atomic<bool> hasNewShards { false };
+    std::mutex shardMutex;
+
+    static inline Registry& getRegistry() noexcept
+    {
+        thread_local Registry registry;
+        return registry;
+    }
+
+    Shard* registerShard(Registry& registry)
+    {
+        // Forget the shards of destroyed queues
+        for (auto it = registry.shards.begin(); it != registry.shards.end();)
+        {
+            if (!it->second->hasConsumer.load(std::memory_order_acquire))
+            {
+                it = registry.shards.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        auto shard = std::make_shared<Shard>();
+        registry.shards.emplace(id, shard);
+        {
+            std::lock_guard<std::mutex> lock(shardMutex);
+            shards.push_back(shard);
+        }
+        hasNewShards.store(true);
+        return shard.get();
+    }
+
+    inline void refreshShards()
+    {
+        if (hasNewShards.load())
+        {
+            std::lock_guard<std::mutex> lock(shardMutex);
+            hasNewShards.store(false);
+            activeShards = shards;
+        }
+    }
+
+    void removeShard(std::size_t index) noexcept
+    {
+        std::lock_guard<std::mutex> lock(shardMutex);
+        const auto shard = activeShards[index];
+        for (auto it = shards.begin(); it != shards.end(); ++it)
+        {
+            if (*it == shard)
+            {
+                shards.erase(it);
+                break;
+            }
+        }
+        activeShards.erase(activeShards.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+};
+
+}
+
+#endif /* ShardedQueue_hpp */
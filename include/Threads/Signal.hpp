@@ -10,82 +10,315 @@
 #define Signal_hpp
 
 #include "Thread.hpp"
+#include "ThreadPool.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <tuple>
-#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace gusc::Threads
 {
 
+/// @brief how a listener is called when a signal is emitted
+enum class ConnectionType : std::uint8_t
+{
+    /// @brief called on the emitting thread if it's the listener's thread, otherwise sent to the listener's thread
+    Auto,
+    /// @brief always called on the emitting thread, the listener's thread is only used to identify the connection
+    Direct,
+    /// @brief always sent to the listener's thread, even if it's the emitting thread
+    Queued,
+    /// @brief sent to the listener's thread and the emitter waits until the listener has finished (called on the emitting thread if
+    /// it's the listener's thread)
+    BlockingQueued
+};
+
+/// @brief ID connecting the trace events of an emission to the deliveries of it's listeners
+/// @note it's empty unless THREADS_ENABLE_TRACING is defined
+struct EmissionTrace
+{
+#if defined(THREADS_ENABLE_TRACING)
+    std::uint64_t id { 0 };
+#endif
+};
+
+template<typename ...TArg>
+class CoalescingSignal;
+
 /// @brief class representing a signal connection and emission object
 template<typename ...TArg>
 class Signal
 {
-    /// @brief internal class representing a single message that wraps the signal data and the listener and is dispatched to a listener's thread
-    class SignalMessage
+    template<typename ...TCoalescedArg>
+    friend class CoalescingSignal;
+    
+    using Callback = std::function<void(const TArg&...)>;
+    using Payload = std::tuple<TArg...>;
+    /// @brief plain function that calls a listener with it's context pointer, used instead of a std::function where possible
+    using Invoker = void(*)(void*, const TArg&...);
+    
+    static constexpr const std::uint32_t InvalidIndex { std::numeric_limits<std::uint32_t>::max() };
+    /// @brief connection IDs keep the slot table index in the low bits and the generation of the entry in the high bits
+    static constexpr const std::size_t IndexBits { sizeof(std::size_t) * 4 };
+    static constexpr const std::size_t IndexMask { (std::size_t(1) << IndexBits) - 1 };
+    
+    /// @brief identity of a listener used to find duplicate connections
+    struct SlotKey
     {
-    public:
-        SignalMessage(const std::function<void(TArg...)>& initCallback, const TArg&... initData)
-            : callback(initCallback)
-            , data(initData...)
-        {}
-        inline void operator()()
+        Thread* hostThread { nullptr };
+        ThreadPool* hostPool { nullptr };
+        void* callbackPtr { nullptr };
+        /// @brief only used to group the slots by their host, listeners are identified regardless of the connection type
+        ConnectionType type { ConnectionType::Auto };
+        
+        inline bool operator==(const SlotKey& other) const noexcept
         {
-            std::apply(callback, data);
+            return hostThread == other.hostThread && hostPool == other.hostPool && callbackPtr == other.callbackPtr && type == other.type;
+        }
+    };
+    
+    struct SlotKeyHash
+    {
+        inline std::size_t operator()(const SlotKey& key) const noexcept
+        {
+            auto hash = std::hash<const void*>{}(key.hostThread);
+            hash ^= std::hash<const void*>{}(key.hostPool) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            hash ^= std::hash<const void*>{}(key.callbackPtr) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            hash ^= static_cast<std::size_t>(key.type) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            return hash;
         }
-    private:
-        std::function<void(TArg...)> callback;
-        std::tuple<TArg...> data;
     };
     
-    /// @brief internal class representing a signal connection slot (listener and it's affinity thread)
+    /// @brief internal class representing a signal connection slot (listener and it's affinity thread or thread pool)
     class Slot
     {
     public:
         Slot() = delete;
-        Slot(Thread* initHostThread, void* initCallbackPtr, const std::function<void(TArg...)>& initCallback)
-            : hostThread(initHostThread)
+        template<typename THost>
+        Slot(THost* initHost, ConnectionType initType, void* initCallbackPtr, const Callback& initCallback)
+            : type(initType)
             , callbackPtr(initCallbackPtr)
-            , callback(initCallback)
-        {}
+            , callback(std::make_shared<const Callback>(initCallback))
+        {
+            setHost(initHost);
+        }
+        template<typename THost>
+        Slot(THost* initHost, ConnectionType initType, void* initCallbackPtr, Invoker initInvoker, void* initContext)
+            : type(initType)
+            , callbackPtr(initCallbackPtr)
+            , invoker(initInvoker)
+            , context(initContext)
+        {
+            setHost(initHost);
+        }
+        
+        /// @return key identifying the listener (a null callback pointer - listener can only be identified by it's connection ID)
+        inline SlotKey getKey() const noexcept
+        {
+            return {hostThread, hostPool, callbackPtr};
+        }
         
-        inline void setConnectionId(size_t newConnectionId) noexcept
+        /// @return key identifying the group of listeners that share the host and the connection type (direct listeners share a
+        /// single group because they don't need their host to be called)
+        inline SlotKey getHostKey() const noexcept
         {
-            connectionId = newConnectionId;
+            if (type == ConnectionType::Direct)
+            {
+                return {nullptr, nullptr, nullptr, type};
+            }
+            return {hostThread, hostPool, nullptr, type};
         }
         
-        inline size_t getConnectionId() const noexcept
+        inline ConnectionType getType() const noexcept
         {
-            return connectionId;
+            return type;
         }
         
-        inline bool operator==(const Slot& other) const noexcept
+        /// @brief check if the calling thread is the listener's thread (or one of the listener's thread pool workers)
+        inline bool getIsHostThread() const noexcept
         {
-            return callbackPtr && hostThread == other.hostThread && callbackPtr != other.callbackPtr;
+            // Nested emissions happen within the host's own run-loop, so they don't need to look up the thread ID
+            if (hostThread && hostThread == Thread::getCurrent())
+            {
+                return true;
+            }
+            const auto threadId = std::this_thread::get_id();
+            return hostThread ? *hostThread == threadId : hostPool && *hostPool == threadId;
         }
         
-        inline void call(const TArg&... args) const
+        /// @brief call the listener on the calling thread
+        inline void invoke(const TArg&... args) const
         {
-            if (!hostThread)
+            if (invoker)
             {
-                throw std::runtime_error("Host thread is null");
+                invoker(context, args...);
+            }
+            else
+            {
+                (*callback)(args...);
+            }
+        }
+        
+        /// @brief send a message to the listener's thread
+        /// @param isBlocking - wait for the message to be executed
+        template<typename TMessage>
+        inline void send(TMessage&& message, bool isBlocking = false) const
+        {
+            if (hostThread)
+            {
+                if (isBlocking)
+                {
+                    hostThread->sendWait(std::forward<TMessage>(message));
+                }
+                else
+                {
+                    hostThread->send(std::forward<TMessage>(message));
+                }
             }
-            if (*hostThread == std::this_thread::get_id())
+            else if (hostPool)
             {
-                callback(args...);
+                if (isBlocking)
+                {
+                    hostPool->sendWait(std::forward<TMessage>(message));
+                }
+                else
+                {
+                    hostPool->send(std::forward<TMessage>(message));
+                }
             }
             else
             {
-                hostThread->send(SignalMessage{callback, args...});
+                throw std::runtime_error("Host thread is null");
             }
         }
         
     private:
         Thread* hostThread { nullptr };
+        ThreadPool* hostPool { nullptr };
+        ConnectionType type { ConnectionType::Auto };
         void* callbackPtr { nullptr };
-        std::function<void(TArg...)> callback;
-        size_t connectionId { 0 };
-
+        std::shared_ptr<const Callback> callback;
+        Invoker invoker { nullptr };
+        void* context { nullptr };
+        
+        template<typename THost>
+        inline void setHost(THost* host) noexcept
+        {
+            if constexpr (std::is_convertible_v<THost*, ThreadPool*>)
+            {
+                hostPool = host;
+            }
+            else
+            {
+                hostThread = host;
+            }
+        }
+    };
+    
+    /// @brief entry of the slot table, free entries keep their generation so that stale connection IDs don't match new slots
+    struct SlotEntry
+    {
+        std::optional<Slot> slot;
+        std::uint32_t generation { 0 };
+        /// @brief previous used entry in the order of connection
+        std::uint32_t previous { InvalidIndex };
+        /// @brief next used entry in the order of connection or next free entry
+        std::uint32_t next { InvalidIndex };
+    };
+    
+    /// @brief slots of one host connected with the same connection type
+    struct HostGroup
+    {
+        ConnectionType type { ConnectionType::Auto };
+        /// @brief indices of the slots in the order of connection
+        std::vector<std::size_t> slots;
+    };
+    
+    /// @brief immutable list of slots with the slots grouped by their host
+    struct SlotList
+    {
+        std::vector<Slot> slots;
+        /// @brief groups in the order of their first slot
+        std::vector<HostGroup> hosts;
+#if defined(THREADS_ENABLE_TRACING)
+        /// @brief signal that published the list, recorded with the deliveries
+        const void* signal { nullptr };
+#endif
+    };
+    
+    /// @brief internal class representing a single message that wraps the signal data and all the listeners of one host and is dispatched to the host's thread
+    class SignalMessage
+    {
+    public:
+        SignalMessage(const std::shared_ptr<const SlotList>& initSlots, std::size_t initHostIndex, const EmissionTrace& initTrace, const TArg&... initData)
+            : slots(initSlots)
+            , hostIndex(initHostIndex)
+            , trace(initTrace)
+            , data(initData...)
+        {}
+        inline void operator()()
+        {
+            callHost(*slots, hostIndex, data, trace);
+        }
+    private:
+        std::shared_ptr<const SlotList> slots;
+        std::size_t hostIndex { 0 };
+        EmissionTrace trace;
+        Payload data;
+    };
+    
+    /// @brief internal class representing a single message that refers to the data of multiple emissions shared by all the hosts
+    class BatchSignalMessage
+    {
+    public:
+        BatchSignalMessage(const std::shared_ptr<const SlotList>& initSlots, std::size_t initHostIndex, const EmissionTrace& initTrace, const std::shared_ptr<const std::vector<Payload>>& initData)
+            : slots(initSlots)
+            , hostIndex(initHostIndex)
+            , trace(initTrace)
+            , data(initData)
+        {}
+        inline void operator()()
+        {
+            for (const auto& d : *data)
+            {
+                callHost(*slots, hostIndex, d, trace);
+            }
+        }
+    private:
+        std::shared_ptr<const SlotList> slots;
+        std::size_t hostIndex { 0 };
+        EmissionTrace trace;
+        std::shared_ptr<const std::vector<Payload>> data;
+    };
+    
+    /// @brief internal class representing a single message that refers to signal data shared by all the hosts of one emission
+    class SharedSignalMessage
+    {
+    public:
+        SharedSignalMessage(const std::shared_ptr<const SlotList>& initSlots, std::size_t initHostIndex, const EmissionTrace& initTrace, const std::shared_ptr<const Payload>& initData)
+            : slots(initSlots)
+            , hostIndex(initHostIndex)
+            , trace(initTrace)
+            , data(initData)
+        {}
+        inline void operator()()
+        {
+            callHost(*slots, hostIndex, *data, trace);
+        }
+    private:
+        std::shared_ptr<const SlotList> slots;
+        std::size_t hostIndex { 0 };
+        EmissionTrace trace;
+        std::shared_ptr<const Payload> data;
     };
     
 public:
@@ -99,32 +332,58 @@ public:
     /// @brief connect a listener callback to this signal
     /// @param thread - listener's thread of affinity
     /// @param callback - listener's callback that will be called when signal is emitted
+    /// @param type - how the listener is called
     /// @return connection ID for disconnecting the slot later or 0 if failed to insert the slot
-    inline size_t connect(Thread* thread, const std::function<void(const TArg&...)>& callback) noexcept
+    inline size_t connect(Thread* thread, const std::function<void(const TArg&...)>& callback, ConnectionType type = ConnectionType::Auto) noexcept
     {
-        typedef void(fnType)(const TArg&...);
-        fnType* const* fnPointer = callback.template target<fnType*>();
-        return connect({thread, fnPointer ? reinterpret_cast<void*>(*fnPointer) : nullptr, callback});
+        return connect(makeSlot(thread, callback, type));
+    }
+    
+    /// @brief connect a listener callback to this signal
+    /// @param pool - listener's thread pool of affinity, callback is executed on any of the pool's workers
+    /// @param callback - listener's callback that will be called when signal is emitted
+    /// @param type - how the listener is called
+    /// @return connection ID for disconnecting the slot later or 0 if failed to insert the slot
+    inline size_t connect(ThreadPool* pool, const std::function<void(const TArg&...)>& callback, ConnectionType type = ConnectionType::Auto) noexcept
+    {
+        return connect(makeSlot(pool, callback, type));
     }
 
     /// @brief connect a listener callback to this signal
     /// @param thread - listener's thread of affinity
     /// @param callback - listener's callback that will be called when signal is emitted
+    /// @param type - how the listener is called
     /// @return connection ID for disconnecting the slot later or 0 if failed to insert the slot
     template<typename TClass>
-    inline size_t connect(TClass* thread, void(TClass::* callback)(const TArg&...)) noexcept
+    inline size_t connect(TClass* thread, void(TClass::* callback)(const TArg&...), ConnectionType type = ConnectionType::Auto) noexcept
     {
-        return connect(Slot{thread, reinterpret_cast<void*&>(callback), [thread, callback](const TArg&... args){(thread->*callback)(args...);}});
+        return connect(Slot{thread, type, reinterpret_cast<void*&>(callback), [thread, callback](const TArg&... args){(thread->*callback)(args...);}});
     }
 
     /// @brief connect a listener callback to this signal
     /// @param thread - listener's thread of affinity
     /// @param callback - listener's callback that will be called when signal is emitted
+    /// @param type - how the listener is called
     /// @return connection ID for disconnecting the slot later or 0 if failed to insert the slot
-    template<typename TClass>
-    inline size_t connect(TClass* thread, void(TClass::* callback)(TArg...)) noexcept
+    template<typename TClass, std::size_t ArgCount = sizeof...(TArg), typename = std::enable_if_t<(ArgCount > 0)>>
+    inline size_t connect(TClass* thread, void(TClass::* callback)(TArg...), ConnectionType type = ConnectionType::Auto) noexcept
+    {
+        return connect(Slot{thread, type, reinterpret_cast<void*&>(callback), [thread, callback](const TArg&... args){(thread->*callback)(args...);}});
+    }
+    
+    /// @brief connect a listener member method known at compile time to this signal, e.g. connect<&MyThread::onValue>(&myThread)
+    /// @note the slot stores only the object pointer and a plain function calling the method, so there's no std::function allocation
+    /// or type erasure
+    /// @param thread - listener's thread of affinity (object the method is called on)
+    /// @param type - how the listener is called
+    /// @return connection ID for disconnecting the slot later or 0 if failed to insert the slot
+    template<auto Method, typename TClass>
+    inline size_t connect(TClass* thread, ConnectionType type = ConnectionType::Auto) noexcept
     {
-        return connect(Slot{thread, reinterpret_cast<void*&>(callback), [thread, callback](const TArg&... args){(thread->*callback)(args...);}});
+        static_assert(std::is_invocable_v<decltype(Method), TClass*, const TArg&...>, "Method can not be called with the signal arguments");
+        // Every method has it's own invoker instance, so the invoker's address identifies the listener
+        Invoker invoker = &Signal::invokeMethod<Method, TClass>;
+        return connect(Slot{thread, type, reinterpret_cast<void*>(invoker), invoker, static_cast<void*>(thread)});
     }
     
     /// @brief disconnect a listener callback from this signal
@@ -133,9 +392,16 @@ public:
     /// @return false if listener was not connected
     inline bool disconnect(Thread* thread, const std::function<void(const TArg&...)>& callback) noexcept
     {
-        typedef void(fnType)(const TArg&...);
-        fnType* const* fnPointer = callback.template target<fnType*>();
-        return disconnect({thread, fnPointer ? reinterpret_cast<void*>(*fnPointer) : nullptr, callback});
+        return disconnect(makeSlot(thread, callback, ConnectionType::Auto));
+    }
+    
+    /// @brief disconnect a listener callback from this signal
+    /// @param pool - listener's thread pool of affinity
+    /// @param callback - listener's callback that will be called when signal is emitted
+    /// @return false if listener was not connected
+    inline bool disconnect(ThreadPool* pool, const std::function<void(const TArg&...)>& callback) noexcept
+    {
+        return disconnect(makeSlot(pool, callback, ConnectionType::Auto));
     }
     
     /// @brief disconnect a listener callback from this signal
@@ -145,17 +411,27 @@ public:
     template<typename TClass>
     inline bool disconnect(TClass* thread, void(TClass::* callback)(const TArg&...)) noexcept
     {
-        return disconnect(Slot{thread, reinterpret_cast<void*&>(callback), [thread, callback](const TArg&... args){(thread->*callback)(args...);}});
+        return disconnect(Slot{thread, ConnectionType::Auto, reinterpret_cast<void*&>(callback), [thread, callback](const TArg&... args){(thread->*callback)(args...);}});
     }
 
     /// @brief disconnect a listener callback from this signal
     /// @param thread - listener's thread of affinity
     /// @param callback - listener's callback that will be called when signal is emitted
     /// @return false if listener was not connected
-    template<typename TClass>
+    template<typename TClass, std::size_t ArgCount = sizeof...(TArg), typename = std::enable_if_t<(ArgCount > 0)>>
     inline bool disconnect(TClass* thread, void(TClass::* callback)(TArg...)) noexcept
     {
-        return disconnect(Slot{thread, reinterpret_cast<void*&>(callback), [thread, callback](const TArg&... args){(thread->*callback)(args...);}});
+        return disconnect(Slot{thread, ConnectionType::Auto, reinterpret_cast<void*&>(callback), [thread, callback](const TArg&... args){(thread->*callback)(args...);}});
+    }
+    
+    /// @brief disconnect a listener member method connected with connect<Method>()
+    /// @param thread - listener's thread of affinity
+    /// @return false if listener was not connected
+    template<auto Method, typename TClass>
+    inline bool disconnect(TClass* thread) noexcept
+    {
+        Invoker invoker = &Signal::invokeMethod<Method, TClass>;
+        return disconnect(Slot{thread, ConnectionType::Auto, reinterpret_cast<void*>(invoker), invoker, static_cast<void*>(thread)});
     }
     
     /// @brief disconnect a listener callback from this signal using it's connection ID
@@ -163,213 +439,440 @@ public:
     /// @return false if no listener with this connection ID was found
     inline bool disconnect(const size_t connectionId) noexcept
     {
-        std::lock_guard<std::mutex> lock(emitMutex);
-        const auto it = std::find_if(slots.begin(), slots.end(), [&connectionId](const Slot& s){
-            return s.getConnectionId() == connectionId;
-        });
-        if (it != slots.end())
-        {
-            slots.erase(it);
-            return true;
-        }
-        return false;
+        std::lock_guard<std::mutex> lock(slotMutex);
+        return removeSlot(connectionId);
     }
     
     /// @brief emit the signal to all of it's listeneres
+    /// @note slots are not locked while the listeners are called, a listener disconnected during emission may still be called once
     /// @param data - signal arguments
-    inline void emit(const TArg&... data) noexcept
+    /// @throws the first exception thrown by a listener called on the emitting thread or a BlockingQueued listener, or by sending to
+    /// a host that doesn't accept messages (std::runtime_error) or discards them (std::future_error) - the emission is still
+    /// delivered to all the other hosts before the exception is re-thrown
+    inline void emit(const TArg&... data)
     {
-        std::lock_guard<std::mutex> lock(emitMutex);
-        for (const auto& l : slots)
+        const auto trace = noteEmitted();
+        std::exception_ptr error;
+        const auto snapshot = getSnapshot();
+        for (std::size_t hostIndex = 0; hostIndex < snapshot->hosts.size(); ++hostIndex)
         {
-            l.call(data...);
+            if (getIsCalledInline(*snapshot, hostIndex))
+            {
+                callHostInline(*snapshot, hostIndex, std::forward_as_tuple(data...), trace, error);
+            }
+            else
+            {
+                // Argument types are not required to be movable, so the message is passed on as a copy
+                const SignalMessage message{snapshot, hostIndex, trace, data...};
+                sendHost(*snapshot, hostIndex, message, error);
+            }
         }
+        rethrowError(error);
     }
     
-private:
-    std::vector<Slot> slots;
-    size_t uniqueIdCounter { 0 };
-    std::mutex emitMutex;
-    
-    inline size_t connect(const Slot& slot) noexcept
+    /// @brief emit the signal to all of it's listeneres copying the data only once for all the listeners on other threads
+    /// @note listeners on other threads receive a reference to the same immutable copy of the data, which is destroyed after the last one of them has finished
+    /// @param data - signal arguments
+    /// @throws the first exception thrown while delivering the emission, same as emit
+    inline void emitShared(const TArg&... data)
     {
-        std::lock_guard<std::mutex> lock(emitMutex);
-        const auto it = std::find(slots.begin(), slots.end(), slot);
-        if (it == slots.end())
+        if constexpr (sizeof...(TArg) == 0)
         {
-            auto& s = slots.emplace_back(slot);
-            ++uniqueIdCounter;
-            s.setConnectionId(uniqueIdCounter);
-            return uniqueIdCounter;
+            emit();
         }
         else
         {
-            return it->getConnectionId();
+            const auto trace = noteEmitted();
+            std::exception_ptr error;
+            std::shared_ptr<const Payload> payload;
+            const auto snapshot = getSnapshot();
+            for (std::size_t hostIndex = 0; hostIndex < snapshot->hosts.size(); ++hostIndex)
+            {
+                if (getIsCalledInline(*snapshot, hostIndex))
+                {
+                    callHostInline(*snapshot, hostIndex, std::forward_as_tuple(data...), trace, error);
+                }
+                else
+                {
+                    if (!payload)
+                    {
+                        payload = std::make_shared<const Payload>(data...);
+                    }
+                    sendHost(*snapshot, hostIndex, SharedSignalMessage{snapshot, hostIndex, trace, payload}, error);
+                }
+            }
+            rethrowError(error);
         }
-        return 0;
     }
     
-    inline bool disconnect(const Slot& slot) noexcept
+    /// @brief emit the signal multiple times sending a single message to every listener's thread
+    /// @note the data is copied once and shared by all the listeners on other threads, listeners receive the emissions in order
+    /// @param first - iterator to the arguments of the first emission (anything that converts to std::tuple<TArg...>)
+    /// @param last - iterator past the arguments of the last emission
+    /// @throws the first exception thrown while delivering the emissions, same as emit
+    template<typename TIterator>
+    inline void emitBatch(TIterator first, TIterator last)
     {
-        std::lock_guard<std::mutex> lock(emitMutex);
-        const auto it = std::find(slots.begin(), slots.end(), slot);
-        if (it != slots.end())
+        const auto trace = noteEmitted();
+        std::exception_ptr error;
+        std::shared_ptr<std::vector<Payload>> payloads;
+        const auto snapshot = getSnapshot();
+        for (std::size_t hostIndex = 0; hostIndex < snapshot->hosts.size(); ++hostIndex)
         {
-            const auto slotIndex = std::distance(slots.begin(), it);
-            slots.erase(it);
-            return true;
+            if (!payloads)
+            {
+                payloads = std::make_shared<std::vector<Payload>>(first, last);
+            }
+            if (getIsCalledInline(*snapshot, hostIndex))
+            {
+                for (const auto& d : *payloads)
+                {
+                    callHostInline(*snapshot, hostIndex, d, trace, error);
+                }
+            }
+            else
+            {
+                sendHost(*snapshot, hostIndex, BatchSignalMessage{snapshot, hostIndex, trace, payloads}, error);
+            }
         }
-        return false;
+        rethrowError(error);
     }
-
-};
-
-/// @brief template specialization for void arguments - unfortunatelly vararg templates can't handle that
-template<>
-class Signal<void>
-{
-    class Slot
+    
+    /// @brief emit the signal multiple times sending a single message to every listener's thread
+    /// @param data - arguments of every emission
+    inline void emitBatch(std::initializer_list<Payload> data)
     {
-    public:
-        Slot() = delete;
-        Slot(Thread* initHostThread, void* initCallbackPtr, const std::function<void(void)>& initCallback)
-            : hostThread(initHostThread)
-            , callbackPtr(initCallbackPtr)
-            , callback(initCallback)
-        {}
-        
-        inline void setConnectionId(size_t newConnectionId) noexcept
+        emitBatch(data.begin(), data.end());
+    }
+    
+private:
+    /// @brief immutable list of slots published for the emitters, it's rebuilt from the slot table by the first emission after a change
+    /// @note with C++20 atomic<shared_ptr> readers only contend on this signal, the C++17 atomic shared_ptr functions take a lock
+    /// from a mutex pool shared by the whole program (libstdc++ and libc++) - either way the lock is held only while the reference
+    /// count is changed, never while the listeners are called
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const SlotList>> slots { std::make_shared<const SlotList>() };
+#else
+    std::shared_ptr<const SlotList> slots { std::make_shared<const SlotList>() };
+#endif
+    /// @brief set when the slot table has changed since the slot list was published
+    std::atomic<bool> isDirty { false };
+    /// @brief slot table (slot map) indexed by connection ID, it's only accessed while holding slotMutex
+    std::vector<SlotEntry> entries;
+    std::uint32_t firstEntry { InvalidIndex };
+    std::uint32_t lastEntry { InvalidIndex };
+    std::uint32_t freeEntry { InvalidIndex };
+    std::size_t slotCount { 0 };
+    /// @brief connection IDs of the listeners that can be identified by their callback pointer
+    std::unordered_map<SlotKey, std::size_t, SlotKeyHash> connectionIds;
+    /// @brief serializes the access to the slot table
+    std::mutex slotMutex;
+    
+    /// @brief call a plain function listener
+    static inline void invokeFunction(void* function, const TArg&... args)
+    {
+        reinterpret_cast<void(*)(const TArg&...)>(function)(args...);
+    }
+    
+    /// @brief call a member method listener known at compile time
+    template<auto Method, typename TClass>
+    static inline void invokeMethod(void* object, const TArg&... args)
+    {
+        (static_cast<TClass*>(object)->*Method)(args...);
+    }
+    
+    /// @brief create a slot for a listener callback, plain functions are called without the std::function
+    template<typename THost>
+    static inline Slot makeSlot(THost* host, const Callback& callback, ConnectionType type)
+    {
+        typedef void(fnType)(const TArg&...);
+        fnType* const* fnPointer = callback.template target<fnType*>();
+        if (fnPointer)
         {
-            connectionId = newConnectionId;
+            const auto function = reinterpret_cast<void*>(*fnPointer);
+            return Slot{host, type, function, &Signal::invokeFunction, function};
         }
-        
-        inline size_t getConnectionId() const noexcept
+        return Slot{host, type, nullptr, callback};
+    }
+    
+    /// @brief check if the listeners of one host must be called on the emitting thread
+    static inline bool getIsCalledInline(const SlotList& slotList, std::size_t hostIndex) noexcept
+    {
+        const auto& group = slotList.hosts[hostIndex];
+        switch (group.type)
         {
-            return connectionId;
+            case ConnectionType::Direct:
+                return true;
+            case ConnectionType::Queued:
+                return false;
+            default:
+                // Blocking on the listener's own thread would never finish, so such listeners are called right away
+                return slotList.slots[group.slots.front()].getIsHostThread();
         }
-        
-        bool operator==(const Slot& other)
+    }
+    
+    /// @brief send a signal message to the thread of one host
+    /// @param error - receives the first exception thrown while sending (or by a BlockingQueued listener), so that the emission still
+    /// reaches the rest of the hosts
+    template<typename TMessage>
+    static inline void sendHost(const SlotList& slotList, std::size_t hostIndex, TMessage&& message, std::exception_ptr& error) noexcept
+    {
+        const auto& group = slotList.hosts[hostIndex];
+        try
         {
-            return callbackPtr && hostThread == other.hostThread && callbackPtr == other.callbackPtr;
+            slotList.slots[group.slots.front()].send(std::forward<TMessage>(message), group.type == ConnectionType::BlockingQueued);
         }
-        
-        void call() const
+        catch (...)
         {
-            if (*hostThread == std::this_thread::get_id())
+            if (!error)
             {
-                callback();
+                error = std::current_exception();
             }
-            else
+        }
+    }
+    
+    /// @brief call all the listeners of one host on the emitting thread
+    /// @param error - receives the first exception thrown by a listener, the rest of the listeners are still called
+    template<typename TData>
+    static inline void callHostInline(const SlotList& slotList, std::size_t hostIndex, const TData& data, const EmissionTrace& trace, std::exception_ptr& error) noexcept
+    {
+        for (const auto slotIndex : slotList.hosts[hostIndex].slots)
+        {
+            try
+            {
+                noteDelivered(slotList, trace);
+                std::apply([&slot = slotList.slots[slotIndex]](const auto&... args){
+                    slot.invoke(args...);
+                }, data);
+            }
+            catch (...)
             {
-                hostThread->send(callback);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
             }
         }
-        
-    private:
-        Thread* hostThread { nullptr };
-        void* callbackPtr { nullptr };
-        std::function<void(void)> callback;
-        size_t connectionId { 0 };
-
-    };
-
-    
-public:
-    Signal() = default;
-    Signal(const Signal<void>&) = delete;
-    Signal& operator=(const Signal<void>&) = delete;
-    Signal(Signal<void>&& other) = delete;
-    Signal& operator=(Signal<void>&& other) = delete;
-    ~Signal() = default;
+    }
     
-    inline bool connect(Thread* thread, const std::function<void(void)>& callback) noexcept
+    /// @brief re-throw the first exception of an emission once it has been delivered to all the hosts
+    static inline void rethrowError(const std::exception_ptr& error)
     {
-        typedef void(fnType)(void);
-        fnType* const* fnPointer = callback.target<fnType*>();
-        return connect({thread, fnPointer ? reinterpret_cast<void*>(*fnPointer) : nullptr, callback});
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
     }
     
-    template<typename TClass>
-    inline bool connect(TClass* thread, void(TClass::* callback)(void)) noexcept
+    /// @brief call all the listeners of one host in the order of connection
+    template<typename TData>
+    static inline void callHost(const SlotList& slotList, std::size_t hostIndex, const TData& data, const EmissionTrace& trace)
     {
-        return connect(Slot{thread, reinterpret_cast<void*&>(callback), [thread, callback](){(thread->*callback)();}});
+        for (const auto slotIndex : slotList.hosts[hostIndex].slots)
+        {
+            noteDelivered(slotList, trace);
+            std::apply([&slot = slotList.slots[slotIndex]](const auto&... args){
+                slot.invoke(args...);
+            }, data);
+        }
     }
     
-    inline bool disconnect(Thread* thread, const std::function<void(void)>& callback) noexcept
+    /// @brief record a trace event of the emission on the emitting thread
+    /// @return trace ID of the emission that is passed on to it's deliveries
+    /// @note trace methods are empty unless THREADS_ENABLE_TRACING is defined
+    inline EmissionTrace noteEmitted() const noexcept
     {
-        typedef void(fnType)(void);
-        fnType* const* fnPointer = callback.target<fnType*>();
-        return disconnect({thread, fnPointer ? reinterpret_cast<void*>(*fnPointer) : nullptr, callback});
+        EmissionTrace trace;
+#if defined(THREADS_ENABLE_TRACING)
+        trace.id = Tracer::getNextId();
+        Tracer::record(TraceEventType::Emit, trace.id, this);
+#endif
+        return trace;
     }
     
-    template<typename TClass>
-    inline bool disconnect(TClass* thread, void(TClass::* callback)(void)) noexcept
+    /// @brief record a trace event of a listener call on the listener's thread
+    static inline void noteDelivered([[maybe_unused]] const SlotList& slotList, [[maybe_unused]] const EmissionTrace& trace) noexcept
     {
-        return disconnect(Slot{thread, reinterpret_cast<void*&>(callback), [thread, callback](){(thread->*callback)();}});
+#if defined(THREADS_ENABLE_TRACING)
+        Tracer::record(TraceEventType::Deliver, trace.id, slotList.signal);
+#endif
     }
-
-    inline bool disconnect(const size_t connectionId) noexcept
+    
+    /// @brief get the current list of slots, publishing a new one if the slot table has changed
+    /// @note the first emission after connect() or disconnect() rebuilds the list while holding slotMutex, so it can wait for a
+    /// connect() or disconnect() on another thread - the following emissions don't take slotMutex until the next change
+    inline std::shared_ptr<const SlotList> getSnapshot()
     {
-        std::lock_guard<std::mutex> lock(emitMutex);
-        const auto it = std::find_if(slots.begin(), slots.end(), [&connectionId](const Slot& s){
-            return s.getConnectionId() == connectionId;
-        });
-        if (it != slots.end())
+        if (isDirty.load(std::memory_order_acquire))
         {
-            slots.erase(it);
-            return true;
+            std::lock_guard<std::mutex> lock(slotMutex);
+            if (isDirty.load(std::memory_order_relaxed))
+            {
+                publishSlots();
+            }
         }
-        return false;
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return slots.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&slots, std::memory_order_acquire);
+#endif
     }
     
-    inline void emit() noexcept
+    /// @brief publish a new slot list from the slot table grouping the slots by their host
+    /// @warning must be called while holding slotMutex
+    inline void publishSlots()
     {
-        std::lock_guard<std::mutex> lock(emitMutex);
-        for (auto& l : slots)
+        auto newSlotList = std::make_shared<SlotList>();
+#if defined(THREADS_ENABLE_TRACING)
+        newSlotList->signal = this;
+#endif
+        newSlotList->slots.reserve(slotCount);
+        std::unordered_map<SlotKey, std::size_t, SlotKeyHash> hostIndices;
+        for (auto entryIndex = firstEntry; entryIndex != InvalidIndex; entryIndex = entries[entryIndex].next)
         {
-            l.call();
+            const auto& slot = newSlotList->slots.emplace_back(*entries[entryIndex].slot);
+            const auto [host, isNewHost] = hostIndices.try_emplace(slot.getHostKey(), newSlotList->hosts.size());
+            if (isNewHost)
+            {
+                newSlotList->hosts.push_back({slot.getType(), {}});
+            }
+            newSlotList->hosts[host->second].slots.push_back(newSlotList->slots.size() - 1);
         }
+#if defined(__cpp_lib_atomic_shared_ptr)
+        slots.store(std::shared_ptr<const SlotList>(std::move(newSlotList)), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&slots, std::shared_ptr<const SlotList>(std::move(newSlotList)), std::memory_order_release);
+#endif
+        isDirty.store(false, std::memory_order_relaxed);
     }
     
-private:
-    std::vector<Slot> slots;
-    size_t uniqueIdCounter { 0 };
-    std::map<size_t, typename std::vector<Slot>::size_type> indexMap;
-    std::mutex emitMutex;
-    
-    inline bool connect(const Slot& slot) noexcept
+    inline size_t connect(const Slot& slot) noexcept
     {
-        std::lock_guard<std::mutex> lock(emitMutex);
-        const auto it = std::find(slots.begin(), slots.end(), slot);
-        if (it == slots.end())
+        std::lock_guard<std::mutex> lock(slotMutex);
+        const auto key = slot.getKey();
+        if (key.callbackPtr)
         {
-            auto& s = slots.emplace_back(slot);
-            ++uniqueIdCounter;
-            s.setConnectionId(uniqueIdCounter);
-            return uniqueIdCounter;
+            const auto it = connectionIds.find(key);
+            if (it != connectionIds.end())
+            {
+                return it->second;
+            }
+        }
+        // Take a free entry or add a new one
+        std::uint32_t entryIndex { freeEntry };
+        if (entryIndex != InvalidIndex)
+        {
+            freeEntry = entries[entryIndex].next;
         }
         else
         {
-            return it->getConnectionId();
+            if (entries.size() >= std::min<std::size_t>(InvalidIndex, IndexMask))
+            {
+                return 0;
+            }
+            entryIndex = static_cast<std::uint32_t>(entries.size());
+            entries.emplace_back();
+        }
+        auto& entry = entries[entryIndex];
+        entry.slot.emplace(slot);
+        // Link the entry at the end of the connection order
+        entry.previous = lastEntry;
+        entry.next = InvalidIndex;
+        if (lastEntry != InvalidIndex)
+        {
+            entries[lastEntry].next = entryIndex;
         }
-        return 0;
+        else
+        {
+            firstEntry = entryIndex;
+        }
+        lastEntry = entryIndex;
+        ++slotCount;
+        const auto connectionId = getConnectionId(entryIndex);
+        if (key.callbackPtr)
+        {
+            connectionIds.emplace(key, connectionId);
+        }
+        isDirty.store(true, std::memory_order_release);
+        return connectionId;
     }
     
     inline bool disconnect(const Slot& slot) noexcept
     {
-        std::lock_guard<std::mutex> lock(emitMutex);
-        const auto it = std::find(slots.begin(), slots.end(), slot);
-        if (it != slots.end())
+        std::lock_guard<std::mutex> lock(slotMutex);
+        const auto key = slot.getKey();
+        if (!key.callbackPtr)
         {
-            const auto slotIndex = std::distance(slots.begin(), it);
-            slots.erase(it);
-            return true;
+            // Listeners without a callback pointer can only be disconnected by their connection ID
+            return false;
         }
-        return false;
+        const auto it = connectionIds.find(key);
+        return it != connectionIds.end() && removeSlot(it->second);
+    }
+    
+    /// @brief connection ID of a used slot table entry
+    /// @warning must be called while holding slotMutex
+    inline std::size_t getConnectionId(std::uint32_t entryIndex) const noexcept
+    {
+        return (static_cast<std::size_t>(entries[entryIndex].generation) << IndexBits) | (static_cast<std::size_t>(entryIndex) + 1);
+    }
+    
+    /// @brief remove a slot from the slot table
+    /// @warning must be called while holding slotMutex
+    /// @return false if no slot has this connection ID
+    inline bool removeSlot(std::size_t connectionId) noexcept
+    {
+        const auto entryNumber = connectionId & IndexMask;
+        if (entryNumber == 0 || entryNumber > entries.size())
+        {
+            return false;
+        }
+        const auto entryIndex = static_cast<std::uint32_t>(entryNumber - 1);
+        auto& entry = entries[entryIndex];
+        if (!entry.slot || getConnectionId(entryIndex) != connectionId)
+        {
+            return false;
+        }
+        const auto key = entry.slot->getKey();
+        if (key.callbackPtr)
+        {
+            connectionIds.erase(key);
+        }
+        // Unlink the entry from the connection order
+        if (entry.previous != InvalidIndex)
+        {
+            entries[entry.previous].next = entry.next;
+        }
+        else
+        {
+            firstEntry = entry.next;
+        }
+        if (entry.next != InvalidIndex)
+        {
+            entries[entry.next].previous = entry.previous;
+        }
+        else
+        {
+            lastEntry = entry.previous;
+        }
+        entry.slot.reset();
+        ++entry.generation;
+        entry.previous = InvalidIndex;
+        entry.next = freeEntry;
+        freeEntry = entryIndex;
+        --slotCount;
+        isDirty.store(true, std::memory_order_release);
+        return true;
     }
 
 };
 
+/// @brief specialization for signals without arguments
+template<>
+class Signal<void> : public Signal<>
+{
+};
+
 }
     
 #endif /* Signal_hpp */
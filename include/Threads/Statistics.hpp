@@ -0,0 +1,220 @@
+//
+//  Statistics.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef Statistics_hpp
+#define Statistics_hpp
+
+#include "MessagePool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef THREADS_STATISTICS_SAMPLE_INTERVAL
+/// @brief one in this many messages gets it's latency and execution time measured
+#   define THREADS_STATISTICS_SAMPLE_INTERVAL 16
+#endif
+
+namespace gusc::Threads
+{
+
+/// @brief copy of a latency histogram with a base 2 logarithmic scale
+struct LatencyHistogramSnapshot
+{
+    /// @brief number of buckets, bucket i counts durations in the range of [2^i, 2^(i+1)) nanoseconds (bucket 0 also counts 0)
+    static constexpr const std::size_t BucketCount { 40 };
+
+    std::array<std::uint64_t, BucketCount> buckets {};
+    std::uint64_t count { 0 };
+    std::chrono::nanoseconds total { 0 };
+    std::chrono::nanoseconds max { 0 };
+
+    inline std::chrono::nanoseconds getMean() const noexcept
+    {
+        return count ? total / static_cast<std::chrono::nanoseconds::rep>(count) : std::chrono::nanoseconds(0);
+    }
+
+    /// @param percentile - percentile in the range of [0, 1]
+    /// @return upper bound of the bucket the percentile falls in
+    inline std::chrono::nanoseconds getPercentile(double percentile) const noexcept
+    {
+        const auto target = static_cast<std::uint64_t>(percentile * static_cast<double>(count));
+        std::uint64_t seen { 0 };
+        for (std::size_t i = 0; i < BucketCount; ++i)
+        {
+            seen += buckets[i];
+            if (seen > target || (seen == count && seen > 0))
+            {
+                return std::min(std::chrono::nanoseconds(std::int64_t(2) << i), max);
+            }
+        }
+        return max;
+    }
+};
+
+/// @brief latency histogram with a base 2 logarithmic scale
+/// @note only a single thread may record durations, snapshots can be taken from any thread
+class LatencyHistogram
+{
+public:
+    inline void record(std::chrono::nanoseconds duration) noexcept
+    {
+        const auto value = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0));
+        auto& bucket = buckets[getBucketIndex(value)];
+        // Single writer, so there's no need for read-modify-write operations
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value > max.load(std::memory_order_relaxed))
+        {
+            max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /// @note counters are read one by one, so a snapshot taken while recording may be off by the durations being recorded
+    inline LatencyHistogramSnapshot getSnapshot() const noexcept
+    {
+        LatencyHistogramSnapshot snapshot;
+        for (std::size_t i = 0; i < LatencyHistogramSnapshot::BucketCount; ++i)
+        {
+            snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count = count.load(std::memory_order_relaxed);
+        snapshot.total = std::chrono::nanoseconds(total.load(std::memory_order_relaxed));
+        snapshot.max = std::chrono::nanoseconds(max.load(std::memory_order_relaxed));
+        return snapshot;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, LatencyHistogramSnapshot::BucketCount> buckets {};
+    std::atomic<std::uint64_t> count { 0 };
+    std::atomic<std::uint64_t> total { 0 };
+    std::atomic<std::uint64_t> max { 0 };
+
+    static inline std::size_t getBucketIndex(std::uint64_t value) noexcept
+    {
+        std::size_t index { 0 };
+        while (value > 1 && index < LatencyHistogramSnapshot::BucketCount - 1)
+        {
+            value >>= 1;
+            ++index;
+        }
+        return index;
+    }
+};
+
+/// @brief snapshot of the run-loop statistics of a Thread
+struct ThreadStatistics
+{
+    /// @brief number of messages placed on the message queue (including expired delayed messages)
+    std::uint64_t messagesQueued { 0 };
+    /// @brief number of messages executed by the run-loop
+    std::uint64_t messagesExecuted { 0 };
+    /// @brief number of messages dropped by the overflow policy of a bounded queue (or rejected by trySend)
+    std::uint64_t messagesDropped { 0 };
+    /// @brief number of times the run-loop has been woken up after parking the thread
+    std::uint64_t wakeUps { 0 };
+    /// @brief number of messages waiting in the message queue
+    std::size_t queueDepth { 0 };
+    /// @brief number of delayed messages waiting for their time
+    std::size_t delayedQueueLength { 0 };
+    /// @brief time from placing sampled messages on the queue until they were started (for delayed messages - from their expiry)
+    LatencyHistogramSnapshot enqueueLatency;
+    /// @brief execution time of sampled messages
+    LatencyHistogramSnapshot executionTime;
+};
+
+/// @brief counters of a Thread's run-loop
+class ThreadCounters
+{
+public:
+    /// @brief count messages being queued by a producer
+    /// @return true if the first of the messages should be sampled
+    inline bool addQueued(std::uint64_t count = 1) noexcept
+    {
+        const auto previous = messagesQueued.fetch_add(count, std::memory_order_relaxed);
+        return previous / SampleInterval != (previous + count) / SampleInterval || previous == 0;
+    }
+
+    /// @brief count a queued message removed by the overflow policy before it was executed
+    inline void addEvicted() noexcept
+    {
+        messagesEvicted.fetch_add(1, std::memory_order_relaxed);
+        addDropped();
+    }
+
+    /// @brief count a message that was not queued because of the overflow policy
+    inline void addDropped() noexcept
+    {
+        messagesDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @note must be called from the run-loop
+    inline void addExecuted() noexcept
+    {
+        messagesExecuted.store(messagesExecuted.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /// @note must be called from the run-loop
+    inline void addWakeUp() noexcept
+    {
+        wakeUps.store(wakeUps.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /// @note must be called from the run-loop
+    inline void recordLatency(std::chrono::nanoseconds latency) noexcept
+    {
+        enqueueLatency.record(latency);
+    }
+
+    /// @note must be called from the run-loop
+    inline void recordExecutionTime(std::chrono::nanoseconds duration) noexcept
+    {
+        executionTime.record(duration);
+    }
+
+    /// @param delayedQueueLength - current length of the delayed queue
+    inline ThreadStatistics getSnapshot(std::size_t delayedQueueLength) const noexcept
+    {
+        ThreadStatistics statistics;
+        statistics.messagesExecuted = messagesExecuted.load(std::memory_order_relaxed);
+        statistics.messagesDropped = messagesDropped.load(std::memory_order_relaxed);
+        statistics.wakeUps = wakeUps.load(std::memory_order_relaxed);
+        const auto evicted = messagesEvicted.load(std::memory_order_relaxed);
+        // Queued counter is read last so that the depth doesn't go negative
+        statistics.messagesQueued = messagesQueued.load(std::memory_order_relaxed);
+        const auto removed = statistics.messagesExecuted + evicted;
+        statistics.queueDepth = statistics.messagesQueued > removed
+            ? static_cast<std::size_t>(statistics.messagesQueued - removed)
+            : 0;
+        statistics.delayedQueueLength = delayedQueueLength;
+        statistics.enqueueLatency = enqueueLatency.getSnapshot();
+        statistics.executionTime = executionTime.getSnapshot();
+        return statistics;
+    }
+
+private:
+    static constexpr const std::uint64_t SampleInterval { THREADS_STATISTICS_SAMPLE_INTERVAL };
+    static_assert(SampleInterval > 0, "THREADS_STATISTICS_SAMPLE_INTERVAL must be positive");
+
+    // Producer and consumer counters are kept on separate cache lines
+    alignas(CacheLineSize) std::atomic<std::uint64_t> messagesQueued { 0 };
+    std::atomic<std::uint64_t> messagesDropped { 0 };
+    std::atomic<std::uint64_t> messagesEvicted { 0 };
+    alignas(CacheLineSize) std::atomic<std::uint64_t> messagesExecuted { 0 };
+    std::atomic<std::uint64_t> wakeUps { 0 };
+    LatencyHistogram enqueueLatency;
+    LatencyHistogram executionTime;
+};
+
+}
+
+#endif /* Statistics_hpp */
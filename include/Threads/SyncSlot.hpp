@@ -0,0 +1,221 @@
+//
+//  SyncSlot.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef SyncSlot_hpp
+#define SyncSlot_hpp
+
+#include "Message.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#if defined(__linux__)
+#   include <linux/futex.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#elif !defined(__cpp_lib_atomic_wait)
+#   include <condition_variable>
+#   include <mutex>
+#endif
+
+namespace gusc::Threads
+{
+
+/// @brief one-shot flag a single thread can block on until another thread sets it
+/// Blocks with a futex on Linux, with std::atomic::wait where it's available and with a condition variable everywhere else. Setting
+/// a flag nobody is blocked on doesn't make any system calls.
+/// @note the setter doesn't touch the flag after the waiter can return, so the flag can live on the waiter's stack
+class WaitFlag
+{
+public:
+    /// @brief set the flag and wake up the waiter
+    inline void set() noexcept
+    {
+#if defined(__linux__)
+        if (state.exchange(Set, std::memory_order_acq_rel) == Sleeping)
+        {
+            // Waking only uses the address of the word, so it's fine if the waiter has already returned and the word is gone
+            syscall(SYS_futex, getWord(), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+#elif defined(__cpp_lib_atomic_wait)
+        if (state.exchange(Waking, std::memory_order_acq_rel) == Sleeping)
+        {
+            state.notify_one();
+        }
+        // Waiter spins while the state is Waking, so this is the last access to the flag
+        state.store(Set, std::memory_order_release);
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        isSet = true;
+        condition.notify_one();
+#endif
+    }
+
+    /// @brief block until the flag is set
+    inline void wait() noexcept
+    {
+#if defined(__linux__) || defined(__cpp_lib_atomic_wait)
+        auto current = state.load(std::memory_order_acquire);
+        if (current == Empty && state.compare_exchange_strong(current, Sleeping, std::memory_order_acq_rel))
+        {
+            current = Sleeping;
+        }
+        while (current != Set)
+        {
+            if (current == Sleeping)
+            {
+#   if defined(__linux__)
+                // Returns right away if the word is not Sleeping any more, spurious wake ups are handled by the loop
+                syscall(SYS_futex, getWord(), FUTEX_WAIT_PRIVATE, Sleeping, nullptr, nullptr, 0);
+#   else
+                state.wait(Sleeping, std::memory_order_acquire);
+#   endif
+            }
+            else
+            {
+                // Setter is between waking this thread and setting the flag
+                std::this_thread::yield();
+            }
+            current = state.load(std::memory_order_acquire);
+        }
+#else
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this](){
+            return isSet;
+        });
+#endif
+    }
+
+private:
+#if defined(__linux__) || defined(__cpp_lib_atomic_wait)
+    enum : std::uint32_t
+    {
+        Empty,
+        Sleeping,
+        Waking,
+        Set
+    };
+
+    std::atomic<std::uint32_t> state { Empty };
+#   if defined(__linux__)
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) && std::atomic<std::uint32_t>::is_always_lock_free, "Futex needs a plain 32-bit word");
+
+    inline std::uint32_t* getWord() noexcept
+    {
+        return reinterpret_cast<std::uint32_t*>(&state);
+    }
+#   endif
+#else
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool isSet { false };
+#endif
+};
+
+/// @brief completion slot of a synchronous call that lives on the caller's stack
+/// Replaces the std::promise/std::future pair - the result is stored in place and the caller is woken up with a WaitFlag, so a
+/// synchronous call doesn't allocate anything but the message.
+template<typename TValue>
+class SyncSlot
+{
+public:
+    SyncSlot() = default;
+    SyncSlot(const SyncSlot&) = delete;
+    SyncSlot& operator=(const SyncSlot&) = delete;
+    SyncSlot(SyncSlot&&) = delete;
+    SyncSlot& operator=(SyncSlot&&) = delete;
+
+    /// @brief call a callable and store it's result (or the exception it threw)
+    template<typename TCallable>
+    void fulfill(TCallable& callable) noexcept
+    {
+        try
+        {
+            if constexpr (std::is_void_v<TValue>)
+            {
+                callable();
+                value.emplace(true);
+            }
+            else
+            {
+                value.emplace(callable());
+            }
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+        flag.set();
+    }
+
+    /// @brief complete the slot with std::future_error(broken_promise), used when the message is destroyed without being called
+    void discard() noexcept
+    {
+        exception = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+        flag.set();
+    }
+
+    /// @brief block until the slot is completed and move the value out or re-throw the exception
+    TValue take()
+    {
+        flag.wait();
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+        if constexpr (!std::is_void_v<TValue>)
+        {
+            return std::move(*value);
+        }
+    }
+
+private:
+    using Storage = std::conditional_t<std::is_void_v<TValue>, bool, TValue>;
+
+    std::optional<Storage> value;
+    std::exception_ptr exception;
+    WaitFlag flag;
+};
+
+/// @brief templated message to wrap a callable object whose result is stored in a SyncSlot
+/// @note if the message is destroyed without being called (i.e. it's dropped by the overflow policy or left on the queue of a
+/// destroyed thread) the waiting caller receives std::future_error with broken_promise
+template<typename TValue, typename TCallable>
+class SyncMessage : public Message
+{
+public:
+    template<typename TInitCallable>
+    SyncMessage(TInitCallable&& initCallableObject, SyncSlot<TValue>& initSlot)
+        : callableObject(std::forward<TInitCallable>(initCallableObject))
+        , slot(&initSlot)
+    {}
+    ~SyncMessage() override
+    {
+        if (slot)
+        {
+            slot->discard();
+        }
+    }
+    void call() override
+    {
+        // The caller may return as soon as the slot is completed, so the slot is not touched afterwards
+        std::exchange(slot, nullptr)->fulfill(callableObject);
+    }
+private:
+    TCallable callableObject;
+    SyncSlot<TValue>* slot { nullptr };
+};
+
+}
+
+#endif /* SyncSlot_hpp */
@@ -9,28 +9,205 @@
 #ifndef Thread_hpp
 #define Thread_hpp
 
+#include "Future.hpp"
+#include "IntrusiveQueue.hpp"
+#include "Message.hpp"
+#include "MpscQueue.hpp"
+#include "NativeThread.hpp"
+#include "PriorityLanes.hpp"
+#include "RingQueue.hpp"
+#include "ShardedQueue.hpp"
+#include "SyncSlot.hpp"
+#if defined(THREADS_ENABLE_STATISTICS)
+#   include "Statistics.hpp"
+#endif
+#include "TimerWheel.hpp"
+#if defined(THREADS_ENABLE_TRACING)
+#   include "Tracing.hpp"
+#endif
+#include "WaitBackend.hpp"
+
 #include <thread>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <queue>
-#include <map>
 #include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <future>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <vector>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   include <immintrin.h>
+#endif
 
 namespace
 {
 constexpr const std::size_t MaxSpinCycles { 1000 };
+/// @brief number of messages a busy run-loop processes between polls of the watched file descriptors
+constexpr const std::size_t IoPollInterval { 64 };
 }
 
 namespace gusc::Threads
 {
 
+/// @brief type of the message queue backing a thread
+enum class QueueType
+{
+    /// @brief mutex protected FIFO queue
+    Locking,
+    /// @brief intrusive lock-free multi-producer/single-consumer queue - producers only take a lock to wake up a parked thread
+    LockFree,
+    /// @brief separate lock-free queue for every producer thread registered on the first send - producers don't share any cache
+    /// lines, the run-loop drains all the queues in turn
+    /// @note messages from one producer are executed in order, there is no order between messages from different producers
+    Sharded
+};
+
+/// @brief what happens when a message is sent to a thread with a full message queue
+enum class OverflowPolicy
+{
+    /// @brief block the sender until there's space in the queue
+    Block,
+    /// @brief discard the message that is being sent
+    DropNewest,
+    /// @brief discard the oldest message in the queue to make space for the new one
+    DropOldest,
+    /// @brief throw an exception
+    Fail
+};
+
+/// @brief thread configuration
+struct ThreadOptions
+{
+    /// @brief type of the message queue to use for the thread
+    QueueType queueType { QueueType::Locking };
+    /// @brief maximum number of messages the run-loop processes after taking all the pending messages off the queue, before it
+    /// looks at the queue and delayed messages again (1 - look at the queue before every message)
+    std::size_t maxBatchSize { 1 };
+    /// @brief number of times the run-loop polls the queue before it parks the thread when there are no messages (0 - park right away)
+    /// @note the run-loop adapts the actual number of spins between spinCycles / 8 and spinCycles depending on whether spinning pays off,
+    /// the value is capped at MaxSpinCycles
+    std::size_t spinCycles { 0 };
+    /// @brief maximum number of messages of each priority waiting in the message queue (0 - unbounded)
+    /// @note a bounded queue is a mutex protected preallocated ring buffer, queueType is ignored
+    /// @note delayed messages don't count towards the capacity once their timeout has run out
+    std::size_t capacity { 0 };
+    /// @brief what happens when a message is sent while the bounded message queue is full
+    OverflowPolicy overflowPolicy { OverflowPolicy::Block };
+    /// @brief what the run-loop blocks on while there are no messages (WaitBackendType::Event is needed to watch file descriptors)
+    WaitBackendType waitBackend { WaitBackendType::ConditionVariable };
+};
+
+/// @brief what happens to the delayed messages that are still waiting for their timeout when a thread is stopped
+enum class DelayedMessagePolicy
+{
+    /// @brief destroy the delayed messages without running them
+    Discard,
+    /// @brief run the delayed messages in the order of their timeouts after the messages on the queue (the deadline still applies)
+    Run,
+    /// @brief hand the delayed messages over to the caller in ShutdownReport::delayedMessages
+    Return
+};
+
+/// @brief how a stopped thread finishes the messages that are left on it's queues
+struct ShutdownOptions
+{
+    /// @brief leftover messages are run until this time, messages still left after it are destroyed without running them
+    /// @note a message that is running at the deadline is not interrupted
+    std::chrono::steady_clock::time_point deadline { std::chrono::steady_clock::time_point::max() };
+    /// @brief what happens to the delayed messages
+    DelayedMessagePolicy delayedPolicy { DelayedMessagePolicy::Discard };
+};
+
+/// @brief delayed message handed over by a stopped thread
+struct DelayedMessage
+{
+    /// @brief time when the message would have been placed on the queue
+    std::chrono::steady_clock::time_point time;
+    std::unique_ptr<Message> message;
+};
+
+/// @brief what happened to the leftover messages of a stopped thread
+struct ShutdownReport
+{
+    /// @brief messages destroyed without running them because the deadline had passed
+    std::size_t droppedMessages { 0 };
+    /// @brief delayed messages destroyed without running them (DelayedMessagePolicy::Discard)
+    std::size_t droppedDelayedMessages { 0 };
+    /// @brief delayed messages in the order of their timeouts (DelayedMessagePolicy::Return)
+    std::vector<DelayedMessage> delayedMessages;
+
+    /// @brief add the leftovers of another thread to this report
+    inline void merge(ShutdownReport&& other)
+    {
+        droppedMessages += other.droppedMessages;
+        droppedDelayedMessages += other.droppedDelayedMessages;
+        delayedMessages.insert(delayedMessages.end(), std::make_move_iterator(other.delayedMessages.begin()), std::make_move_iterator(other.delayedMessages.end()));
+    }
+};
+
+class ThreadGroup;
+
 /// @brief Class representing a new thread
 class Thread
 {
 public:
+    /// @brief handle of a delayed message, used to cancel or reschedule the message before it's timeout runs out
+    /// @warning handle must not be used after the thread object is destroyed
+    class TimerHandle
+    {
+    public:
+        TimerHandle() = default;
+        
+        /// @brief cancel the delayed message - message object is destroyed right away
+        /// @return false if the message has already been placed on the message queue or cancelled
+        inline bool cancel()
+        {
+            return thread && thread->cancelDelayed(id);
+        }
+        
+        /// @brief move the delayed message to a new timeout counted from now
+        /// @return false if the message has already been placed on the message queue or cancelled
+        inline bool reschedule(const std::chrono::milliseconds& timeout)
+        {
+            return thread && thread->rescheduleDelayed(id, timeout);
+        }
+        
+    private:
+        friend class Thread;
+        
+        TimerHandle(Thread* initThread, const TimerId& initId)
+            : thread(initThread)
+            , id(initId)
+        {}
+        
+        Thread* thread { nullptr };
+        TimerId id;
+    };
+    
     Thread() = default;
+    /// @param initQueueType - type of the message queue to use for this thread
+    explicit Thread(QueueType initQueueType)
+        : Thread(ThreadOptions{initQueueType})
+    {}
+    /// @param initOptions - thread configuration
+    explicit Thread(const ThreadOptions& initOptions)
+        : queueType(initOptions.capacity ? QueueType::Locking : initOptions.queueType)
+        , overflowPolicy(initOptions.overflowPolicy)
+        , capacity(initOptions.capacity)
+        , waitBackend(makeWaitBackend(initOptions.waitBackend))
+        , boundedQueues(initOptions.capacity)
+        , maxBatchSize(std::max<std::size_t>(initOptions.maxBatchSize, 1))
+        , spinCycles(std::min(initOptions.spinCycles, MaxSpinCycles))
+        , spinLimit(spinCycles)
+    {}
     Thread(const Thread&) = delete;
     Thread& operator=(const Thread&) = delete;
     Thread(Thread&&) = delete;
@@ -39,17 +216,41 @@ public:
     {
         setIsAcceptingMessages(false);
         setIsRunning(false);
-        queueWait.notify_one();
+        wakeUp();
         join();
     }
     
     /// @brief start the thread and it's run-loop
     virtual void start()
+    {
+        start(StartOptions{});
+    }
+
+    /// @brief start the thread and it's run-loop
+    /// @param options - CPU affinity, NUMA node, scheduling, name and stack size of the thread, options are applied before the run-loop starts
+    /// @note if a NUMA node is set the bounded message queues are moved to the memory of that node
+    /// @throws std::runtime_error if any of the options can not be applied (the thread is not started then)
+    virtual void start(const StartOptions& options)
     {
         if (!getIsRunning())
         {
             setIsRunning(true);
-            thread = std::make_unique<std::thread>(&Thread::runLoop, this);
+            try
+            {
+                thread = std::make_unique<NativeThread>(options, [this, isNumaLocal = options.numaNode >= 0]()
+                {
+                    if (isNumaLocal)
+                    {
+                        reallocateQueues();
+                    }
+                    runLoop();
+                });
+            }
+            catch (...)
+            {
+                setIsRunning(false);
+                throw;
+            }
         }
         else
         {
@@ -60,12 +261,18 @@ public:
     /// @brief signal the thread to stop - this also stops receiving messages
     /// @warning if a message is sent after calling this method an exception will be thrown
     virtual void stop()
+    {
+        stop(ShutdownOptions{});
+    }
+    
+    /// @brief signal the thread to stop and choose how it finishes the leftover messages - this also stops receiving messages
+    /// @param options - deadline for running the leftover messages and what happens to the delayed messages
+    /// @warning if a message is sent after calling this method an exception will be thrown
+    virtual void stop(const ShutdownOptions& options)
     {
         if (thread)
         {
-            setIsAcceptingMessages(false);
-            setIsRunning(false);
-            queueWait.notify_one();
+            requestStop(options);
         }
         else
         {
@@ -82,16 +289,22 @@ public:
         }
     }
     
+    /// @brief take the report of what happened to the leftover messages when the thread stopped
+    /// @warning must only be called after the thread has been joined (or the run-loop of ThisThread has returned)
+    ShutdownReport takeShutdownReport() noexcept
+    {
+        return std::exchange(shutdownReport, ShutdownReport{});
+    }
+    
     /// @brief send a message that needs to be executed on this thread
-    /// @param newMessage - any callable object that will be executed on this thread
+    /// @param newMessage - any callable object that will be executed on this thread (temporaries and move-only callables are moved, not copied)
+    /// @param priority - priority of the message, higher priority messages are executed before lower priority messages
     template<typename TCallable>
-    void send(const TCallable& newMessage)
+    void send(TCallable&& newMessage, Priority priority = Priority::Normal)
     {
         if (getIsAcceptingMessages())
         {
-            std::lock_guard<std::mutex> lock(messageMutex);
-            messageQueue.emplace(std::make_unique<CallableMessage<TCallable>>(newMessage));
-            queueWait.notify_one();
+            pushMessage(std::make_unique<CallableMessage<std::decay_t<TCallable>>>(std::forward<TCallable>(newMessage)), priority);
         }
         else
         {
@@ -99,17 +312,98 @@ public:
         }
     }
     
+    /// @brief send a message that needs to be executed on this thread unless the bounded message queue is full
+    /// @param newMessage - any callable object that will be executed on this thread (temporaries and move-only callables are moved, not copied)
+    /// @param priority - priority of the message
+    /// @return false if the message queue is full (the message is discarded), this method never blocks regardless of the overflow policy
+    template<typename TCallable>
+    bool trySend(TCallable&& newMessage, Priority priority = Priority::Normal)
+    {
+        if (getIsAcceptingMessages())
+        {
+            std::unique_ptr<Message> message = std::make_unique<CallableMessage<std::decay_t<TCallable>>>(std::forward<TCallable>(newMessage));
+            if (capacity)
+            {
+                return pushBoundedMessage(message, priority, true);
+            }
+            pushMessage(std::move(message), priority);
+            return true;
+        }
+        else
+        {
+            throw std::runtime_error("Thread is not excepting any messages, the thread has been signaled for stopping");
+        }
+    }
+    
+    /// @brief send multiple messages that need to be executed on this thread with a single queue operation and a single wake up
+    /// @note messages are placed on a bounded message queue one by one applying the overflow policy to each of them
+    /// @param first - iterator to the first callable object (use std::move_iterator to move the callables instead of copying them)
+    /// @param last - iterator past the last callable object
+    /// @param priority - priority of the messages
+    template<typename TIterator>
+    void sendBatch(TIterator first, TIterator last, Priority priority = Priority::Normal)
+    {
+        if (getIsAcceptingMessages())
+        {
+            using TCallable = std::decay_t<decltype(*first)>;
+            IntrusiveQueue<Message> batch;
+            for (; first != last; ++first)
+            {
+                batch.push(std::make_unique<CallableMessage<TCallable>>(*first).release());
+            }
+            pushMessages(batch, priority);
+        }
+        else
+        {
+            throw std::runtime_error("Thread is not excepting any messages, the thread has been signaled for stopping");
+        }
+    }
+    
+    /// @brief send multiple messages that need to be executed on this thread with a single queue operation and a single wake up
+    /// @param range - container of callable objects (callables are moved out of a temporary container)
+    /// @param priority - priority of the messages
+    template<typename TRange, typename = decltype(std::begin(std::declval<TRange&>()))>
+    void sendBatch(TRange&& range, Priority priority = Priority::Normal)
+    {
+        if constexpr (std::is_rvalue_reference_v<TRange&&>)
+        {
+            sendBatch(std::make_move_iterator(std::begin(range)), std::make_move_iterator(std::end(range)), priority);
+        }
+        else
+        {
+            sendBatch(std::begin(range), std::end(range), priority);
+        }
+    }
+    
+    /// @brief send multiple messages that need to be executed on this thread with a single queue operation and a single wake up
+    /// @param messages - callable objects
+    /// @param priority - priority of the messages
+    template<typename TCallable>
+    void sendBatch(std::initializer_list<TCallable> messages, Priority priority = Priority::Normal)
+    {
+        sendBatch(messages.begin(), messages.end(), priority);
+    }
+    
     /// @brief send a delayed message that needs to be executed on this thread
-    /// @param newMessage - any callable object that will be executed on this thread
+    /// @note delayed messages are placed on the normal priority queue once their timeout runs out
+    /// @param newMessage - any callable object that will be executed on this thread (temporaries and move-only callables are moved, not copied)
+    /// @return handle that can be used to cancel or reschedule the message
     template<typename TCallable>
-    void sendDelayed(const TCallable& newMessage, const std::chrono::milliseconds& timeout)
+    TimerHandle sendDelayed(TCallable&& newMessage, const std::chrono::milliseconds& timeout)
     {
         if (getIsAcceptingMessages())
         {
+            auto message = std::make_unique<CallableMessage<std::decay_t<TCallable>>>(std::forward<TCallable>(newMessage));
             std::lock_guard<std::mutex> lock(messageMutex);
             auto time = std::chrono::steady_clock::now() + timeout;
-            delayedQueue.emplace(time, std::make_unique<CallableMessage<TCallable>>(newMessage));
-            queueWait.notify_one();
+            const auto id = delayedQueue.insert(time, std::move(message));
+            updateNextDelayedTime();
+            if (isWaiting)
+            {
+                // Parked thread needs to re-evaluate it's wake up time
+                waitBackend->notify();
+            }
+            return TimerHandle(this, id);
         }
         else
         {
@@ -120,8 +414,9 @@ public:
     /// @brief send an asynchronous message that returns value and needs to be executed on this thread (calling thread is not blocked)
     /// @note if sent from the same thread this method will call the callable immediatelly to prevent deadlocking
     /// @param newMessage - any callable object that will be executed on this thread and it must return a value of type specified in TReturn (signature: TReturn(void))
+    /// @param priority - priority of the message
     template<typename TReturn, typename TCallable>
-    std::future<TReturn> sendAsync(const TCallable& newMessage)
+    std::future<TReturn> sendAsync(TCallable&& newMessage, Priority priority = Priority::Normal)
     {
         if (getIsAcceptingMessages())
         {
@@ -130,14 +425,44 @@ public:
             if (getIsSameThread())
             {
                 // If we are on the same thread excute message immediatelly to prent a deadlock
-                auto message = std::make_unique<CallableMessageWithPromise<TReturn, TCallable>>(newMessage, std::move(promise));
+                auto message = std::make_unique<CallableMessageWithPromise<TReturn, std::decay_t<TCallable>>>(std::forward<TCallable>(newMessage), std::move(promise));
                 message->call();
             }
             else
             {
-                std::lock_guard<std::mutex> lock(messageMutex);
-                messageQueue.emplace(std::make_unique<CallableMessageWithPromise<TReturn, TCallable>>(newMessage, std::move(promise)));
-                queueWait.notify_one();
+                pushMessage(std::make_unique<CallableMessageWithPromise<TReturn, std::decay_t<TCallable>>>(std::forward<TCallable>(newMessage), std::move(promise)), priority);
+            }
+            return future;
+        }
+        else
+        {
+            throw std::runtime_error("Thread is not excepting any messages, the thread has been signaled for stopping");
+        }
+    }
+    
+    /// @brief send an asynchronous message that returns value and needs to be executed on this thread, the result can be continued on another thread
+    /// @note if sent from the same thread this method will call the callable immediatelly to prevent deadlocking
+    /// @param newMessage - any callable object that will be executed on this thread and it must return a value of type specified in TReturn (signature: TReturn(void)), exceptions are passed to the future
+    /// @param priority - priority of the message
+    /// @return lightweight future that can be continued with then() without blocking or waited for with get()
+    template<typename TReturn, typename TCallable>
+    Future<TReturn> sendFuture(TCallable&& newMessage, Priority priority = Priority::Normal)
+    {
+        if (getIsAcceptingMessages())
+        {
+            Promise<TReturn> promise;
+            auto future = promise.getFuture();
+            if (getIsSameThread())
+            {
+                // If we are on the same thread excute message immediatelly to prent a deadlock
+                promise.fulfill(std::forward<TCallable>(newMessage));
+            }
+            else
+            {
+                auto message = [promise = std::move(promise), callable = std::forward<TCallable>(newMessage)]() mutable {
+                    promise.fulfill(callable);
+                };
+                pushMessage(std::make_unique<CallableMessage<decltype(message)>>(std::move(message)), priority);
             }
             return future;
         }
@@ -150,25 +475,79 @@ public:
     /// @brief send a synchronous message that returns value and needs to be executed on this thread (calling thread is blocked until message returns)
     /// @note to prevent deadlocking this method throws exception if called before thread has started
     /// @param newMessage - any callable object that will be executed on this thread and it must return a value of type specified in TReturn (signature: TReturn(void))
+    /// @param priority - priority of the message
+    /// @throws the exception thrown by the callable, std::future_error with broken_promise if the message is discarded without being called
     template<typename TReturn, typename TCallable>
-    TReturn sendSync(const TCallable& newMessage)
+    TReturn sendSync(TCallable&& newMessage, Priority priority = Priority::Normal)
     {
         if (!getIsRunning())
         {
             throw std::runtime_error("Can not place a blocking message if the thread is not started");
         }
-        auto future = sendAsync<TReturn>(newMessage);
-        return future.get();
+        if (!getIsAcceptingMessages())
+        {
+            throw std::runtime_error("Thread is not excepting any messages, the thread has been signaled for stopping");
+        }
+        if (getIsSameThread())
+        {
+            // If we are on the same thread execute the message immediately to prevent a deadlock
+            // Callable is copied, so that callables with a non-const call operator can be passed as const references
+            std::decay_t<TCallable> callable(std::forward<TCallable>(newMessage));
+            if constexpr (std::is_void_v<TReturn>)
+            {
+                callable();
+                return;
+            }
+            else
+            {
+                return callable();
+            }
+        }
+        // Result is passed back through a slot on this stack instead of a std::promise
+        SyncSlot<TReturn> slot;
+        pushMessage(std::make_unique<SyncMessage<TReturn, std::decay_t<TCallable>>>(std::forward<TCallable>(newMessage), slot), priority);
+        return slot.take();
     }
     
     /// @brief send a message that needs to be executed on this thread and wait for it's completion
     /// @param newMessage - any callable object that will be executed on this thread
+    /// @param priority - priority of the message
     template<typename TCallable>
-    void sendWait(const TCallable& newMessage)
+    void sendWait(TCallable&& newMessage, Priority priority = Priority::Normal)
+    {
+        sendSync<void>(std::forward<TCallable>(newMessage), priority);
+    }
+    
+    /// @brief call a callback on this thread whenever a file descriptor is ready, readiness is level-triggered
+    /// @note the run-loop waits for it's messages and the file descriptors with a single system call, while it's busy with messages
+    /// the descriptors are polled every few messages
+    /// @param fd - file descriptor, it must stay open until it's unwatched (watching it again replaces the events and the callback)
+    /// @param events - IoEvents::Read and/or IoEvents::Write
+    /// @param callback - callable object that takes the events the descriptor is ready for (signature: void(IoEvents))
+    /// @throws std::runtime_error if the thread is not constructed with WaitBackendType::Event or the descriptor can not be watched
+    template<typename TCallable>
+    void watch(int fd, IoEvents events, TCallable&& callback)
+    {
+        waitBackend->watch(fd, events, std::forward<TCallable>(callback));
+        // Parked run-loop has to start dispatching the events
+        std::lock_guard<std::mutex> lock(messageMutex);
+        waitBackend->notify();
+    }
+    
+    /// @brief stop watching a file descriptor
+    /// @note when called from another thread a callback that has already started may still be running when this returns
+    /// @return false if the descriptor was not watched
+    bool unwatch(int fd)
     {
-        sendSync<void>(newMessage);
+        return waitBackend->unwatch(fd);
     }
         
+    /// @return thread whose run-loop is running on the calling thread (nullptr if the calling thread is not running a run-loop)
+    static inline Thread* getCurrent() noexcept
+    {
+        return currentLoop();
+    }
+    
     inline bool operator==(const Thread& other) const noexcept
     {
         return getId() == other.getId();
@@ -186,73 +565,151 @@ public:
         return !(operator==(other));
     }
     
+#if defined(THREADS_ENABLE_STATISTICS)
+    /// @brief take a snapshot of the run-loop statistics
+    /// @note only available if THREADS_ENABLE_STATISTICS is defined, counters are read one by one so they may be slightly out of sync on a busy thread
+    ThreadStatistics getStatistics()
+    {
+        std::size_t delayedQueueLength { 0 };
+        {
+            std::lock_guard<std::mutex> lock(messageMutex);
+            delayedQueueLength = delayedQueue.size();
+        }
+        return counters.getSnapshot(delayedQueueLength);
+    }
+    
+#endif
 protected:
     void runLoop()
     {
+        // ThisThread can be started from within another run-loop, so the outer one is restored when this one finishes
+        const auto outerLoop = std::exchange(currentLoop(), this);
         while (getIsRunning())
         {
-            std::unique_ptr<Message> next;
+            auto next = (queueType == QueueType::LockFree) ? getNextLockFreeMessage()
+                : (queueType == QueueType::Sharded) ? getNextShardedMessage()
+                : getNextMessage();
+            if (next)
             {
-                const auto timeNow = std::chrono::steady_clock::now();
-                std::unique_lock<std::mutex> lock(messageMutex);
-                // Wait for any messages to arrive
-                if (messageQueue.empty() && delayedQueue.empty())
+                missCounter = 0;
+                callMessage(*next);
+            }
+            if (waitBackend->getIsWatching())
+            {
+                dispatchIoEvents(next != nullptr);
+            }
+        }
+        runLeftovers();
+        currentLoop() = outerLoop;
+    }
+    
+    void runLeftovers()
+    {
+        std::vector<DelayedMessage> delayedMessages;
+        auto delayedPolicy = DelayedMessagePolicy::Discard;
+        {
+            std::lock_guard<std::mutex> lock(messageMutex);
+            drainDeadline = shutdownOptions.deadline;
+            delayedPolicy = shutdownOptions.delayedPolicy;
+            delayedQueue.drain([&delayedMessages](const auto& time, std::unique_ptr<Message>&& message){
+                delayedMessages.push_back(DelayedMessage{time, std::move(message)});
+            });
+            updateNextDelayedTime();
+        }
+        // Process any leftover messages
+        while (auto next = std::unique_ptr<Message>(pendingMessages.pop()))
+        {
+            runLeftover(std::move(next));
+        }
+        if (queueType == QueueType::LockFree)
+        {
+            while (!lockFreeQueues.empty())
+            {
+                if (auto next = std::unique_ptr<Message>(lockFreeQueues.pop()))
                 {
-                    // We wait for a new message to be pushed on any of the queues
-                    queueWait.wait(lock);
+                    runLeftover(std::move(next));
                 }
-                // Move delayed messages to main queue
-                if (!delayedQueue.empty())
+                else
                 {
-                    auto hasNew { false };
-                    for (auto it = delayedQueue.begin(); it != delayedQueue.end();)
-                    {
-                        if (it->first < timeNow)
-                        {
-                            messageQueue.emplace(std::move(it->second));
-                            it = delayedQueue.erase(it);
-                            hasNew = true;
-                        }
-                        else
-                        {
-                            break;
-                        }
-                    }
-                    if (!hasNew)
-                    {
-                        // If there are queued items but none were added to the queue wait till next queued item
-                        auto nextTime = delayedQueue.lower_bound(timeNow);
-                        if (nextTime != delayedQueue.end())
-                        {
-                            queueWait.wait_until(lock, nextTime->first);
-                        }
-                    }
+                    std::this_thread::yield();
                 }
-                // Get the next message from the main queue
-                if (!messageQueue.empty())
+            }
+        }
+        else if (queueType == QueueType::Sharded)
+        {
+            while (!getIsShardedQueueEmpty())
+            {
+                takeShardedMessages();
+                if (pendingMessages.empty())
+                {
+                    std::this_thread::yield();
+                }
+                while (auto next = std::unique_ptr<Message>(pendingMessages.pop()))
                 {
-                    next = std::move(messageQueue.front());
-                    messageQueue.pop();
+                    runLeftover(std::move(next));
                 }
             }
-            if (next)
+        }
+        else
+        {
+            // Take the messages off the queue in batches, so that they are not called while holding the lock
+            for (;;)
             {
-                missCounter = 0;
-                next->call();
+                {
+                    std::lock_guard<std::mutex> lock(messageMutex);
+                    takeMessages(capacity);
+                }
+                if (pendingMessages.empty())
+                {
+                    break;
+                }
+                while (auto next = std::unique_ptr<Message>(pendingMessages.pop()))
+                {
+                    runLeftover(std::move(next));
+                }
             }
         }
-        runLeftovers();
+        // Delayed messages are destroyed outside of the lock, as their destructors may do anything
+        switch (delayedPolicy)
+        {
+            case DelayedMessagePolicy::Run:
+                for (auto& delayed : delayedMessages)
+                {
+                    runLeftover(std::move(delayed.message));
+                }
+                break;
+            case DelayedMessagePolicy::Return:
+                shutdownReport.delayedMessages = std::move(delayedMessages);
+                break;
+            default:
+                shutdownReport.droppedDelayedMessages += delayedMessages.size();
+                break;
+        }
     }
     
-    void runLeftovers()
+    /// @brief run a leftover message unless the shutdown deadline has passed, then the message is destroyed without running it
+    inline void runLeftover(std::unique_ptr<Message> message)
     {
-        // Process any leftover messages
-        std::lock_guard<std::mutex> lock(messageMutex);
-        while (messageQueue.size())
+        if (drainDeadline != std::chrono::steady_clock::time_point::max() && (drainDeadline == std::chrono::steady_clock::time_point::min() || std::chrono::steady_clock::now() >= drainDeadline))
         {
-            messageQueue.front()->call();
-            messageQueue.pop();
+            // Once the deadline has passed the rest of the messages are dropped without looking at the clock
+            drainDeadline = std::chrono::steady_clock::time_point::min();
+            ++shutdownReport.droppedMessages;
+            return;
         }
+        callMessage(*message);
+    }
+    
+    /// @brief signal the run-loop to stop without checking if the thread has been started
+    void requestStop(const ShutdownOptions& options)
+    {
+        {
+            std::lock_guard<std::mutex> lock(messageMutex);
+            shutdownOptions = options;
+        }
+        setIsAcceptingMessages(false);
+        setIsRunning(false);
+        wakeUp();
     }
     
     inline std::thread::id getId() const noexcept
@@ -290,75 +747,636 @@ protected:
     
     inline bool getIsSameThread() const noexcept
     {
-        return getId() == std::this_thread::get_id();
+        return currentLoop() == this || getId() == std::this_thread::get_id();
+    }
+
+    /// @brief move the preallocated queue memory to the memory policy of the calling thread
+    void reallocateQueues()
+    {
+        if (capacity)
+        {
+            std::lock_guard<decltype(messageMutex)> lock(messageMutex);
+            for (const auto priority : { Priority::Low, Priority::Normal, Priority::High })
+            {
+                boundedQueues[priority].reallocate();
+            }
+        }
     }
 
 private:
+    // Group signals all of it's threads before joining any of them
+    friend class ThreadGroup;
     
-    /// @brief base class for thread message
-    class Message
+    /// @brief place a message on the main queue and wake up the thread if necessary
+    inline void pushMessage(std::unique_ptr<Message> message, Priority priority)
     {
-    public:
-        virtual ~Message() = default;
-        virtual void call() {}
-    };
+        if (capacity)
+        {
+            pushBoundedMessage(message, priority, false);
+        }
+        else if (queueType != QueueType::Locking)
+        {
+            noteQueued(*message);
+            auto& queues = (queueType == QueueType::Sharded) ? shardedQueues.getLocalLanes() : lockFreeQueues;
+            queues[priority].push(message.release());
+            // Only a thread that has announced it's going to sleep needs a notification
+            if (isWaiting)
+            {
+                std::lock_guard<std::mutex> lock(messageMutex);
+                waitBackend->notify();
+            }
+        }
+        else if (currentLoop() == this)
+        {
+            // Sent from one of this thread's own messages, the run-loop picks it up after the current message without locking
+            noteQueued(*message);
+            pendingMessages[priority].push(message.release());
+        }
+        else
+        {
+            noteQueued(*message);
+            std::lock_guard<std::mutex> lock(messageMutex);
+            messageQueues[priority].push(message.release());
+            hasQueuedMessages.store(true, std::memory_order_relaxed);
+            if (isWaiting)
+            {
+                waitBackend->notify();
+            }
+        }
+    }
     
-    /// @brief templated message to wrap a callable object
-    template<typename TCallable>
-    class CallableMessage : public Message
+    /// @brief place a batch of messages on the main queue and wake up the thread if necessary
+    inline void pushMessages(IntrusiveQueue<Message>& batch, Priority priority)
     {
-    public:
-        CallableMessage(const TCallable& initCallableObject)
-            : callableObject(initCallableObject)
-        {}
-        void call() override
+        if (batch.empty())
         {
-            callableObject();
+            return;
         }
-    private:
-        TCallable callableObject;
-    };
+        if (capacity)
+        {
+            while (auto message = std::unique_ptr<Message>(batch.pop()))
+            {
+                pushBoundedMessage(message, priority, false);
+            }
+        }
+        else if (queueType != QueueType::Locking)
+        {
+            noteQueued(*batch.front(), batch.size());
+            auto& queues = (queueType == QueueType::Sharded) ? shardedQueues.getLocalLanes() : lockFreeQueues;
+            const auto chain = batch.release();
+            queues[priority].push(chain.first, chain.second);
+            if (isWaiting)
+            {
+                std::lock_guard<std::mutex> lock(messageMutex);
+                waitBackend->notify();
+            }
+        }
+        else if (currentLoop() == this)
+        {
+            noteQueued(*batch.front(), batch.size());
+            pendingMessages[priority].splice(batch);
+        }
+        else
+        {
+            noteQueued(*batch.front(), batch.size());
+            std::lock_guard<std::mutex> lock(messageMutex);
+            messageQueues[priority].splice(batch);
+            hasQueuedMessages.store(true, std::memory_order_relaxed);
+            if (isWaiting)
+            {
+                waitBackend->notify();
+            }
+        }
+    }
     
-    /// @brief templated message to wrap a callable object which accepts promise object that can be used to signal finish of the callable (useful for subsequent async calls)
-    template<typename TReturn, typename TCallable>
-    class CallableMessageWithPromise : public Message
+    /// @brief place a message on the bounded queue applying the overflow policy if the queue is full
+    /// @param message - message to place on the queue, it's left in the pointer if it's not placed on the queue
+    /// @param priority - priority of the message, every priority has it's own bounded queue
+    /// @param isTry - fail instead of applying the overflow policy
+    /// @return false if the message was not placed on the queue
+    bool pushBoundedMessage(std::unique_ptr<Message>& message, Priority priority, bool isTry)
     {
-    public:
-        CallableMessageWithPromise(const TCallable& initCallableObject, std::promise<TReturn> initWaitablePromise)
-            : callableObject(initCallableObject)
-            , waitablePromise(std::move(initWaitablePromise))
-        {}
-        void call() override
+        // Dropped message is destroyed outside the lock as destructors of it's captures may want to send messages
+        std::unique_ptr<Message> droppedMessage;
+        std::unique_lock<std::mutex> lock(messageMutex);
+        auto& boundedQueue = boundedQueues[priority];
+        if (boundedQueue.full())
         {
-            actualCall<TReturn>();
+            if (isTry)
+            {
+                noteDropped();
+                return false;
+            }
+            switch (overflowPolicy)
+            {
+                case OverflowPolicy::Block:
+                    if (getIsSameThread())
+                    {
+                        throw std::runtime_error("Message queue is full, can not block the sender on the same thread");
+                    }
+                    ++waitingProducers;
+                    spaceWait.wait(lock, [this, &boundedQueue](){
+                        return !boundedQueue.full() || !getIsAcceptingMessages();
+                    });
+                    --waitingProducers;
+                    if (!getIsAcceptingMessages())
+                    {
+                        throw std::runtime_error("Thread is not excepting any messages, the thread has been signaled for stopping");
+                    }
+                    break;
+                case OverflowPolicy::DropNewest:
+                    noteDropped();
+                    return false;
+                case OverflowPolicy::DropOldest:
+                    droppedMessage.reset(boundedQueue.pop());
+                    noteEvicted();
+                    break;
+                case OverflowPolicy::Fail:
+                    noteDropped();
+                    throw std::runtime_error("Message queue is full");
+            }
         }
-    private:
-        TCallable callableObject;
-        std::promise<TReturn> waitablePromise;
-        
-        template<typename TR>
-        void actualCall()
+        noteQueued(*message);
+        boundedQueue.push(message.release());
+        hasQueuedMessages.store(true, std::memory_order_relaxed);
+        if (isWaiting)
         {
-            waitablePromise.set_value(callableObject());
+            waitBackend->notify();
         }
-        
-        template<>
-        void actualCall<void>()
+        return true;
+    }
+    
+    /// @brief move the queued messages to the pending messages
+    /// @param maxBoundedCount - maximum number of messages to take from each of the bounded queues
+    /// @warning must be called while holding messageMutex
+    inline void takeMessages(std::size_t maxBoundedCount) noexcept
+    {
+        pendingMessages.splice(messageQueues);
+        if (capacity)
         {
-            callableObject();
-            waitablePromise.set_value();
+            for (const auto priority : { Priority::High, Priority::Normal, Priority::Low })
+            {
+                auto& boundedQueue = boundedQueues[priority];
+                for (std::size_t i = 0; i < maxBoundedCount && !boundedQueue.empty(); ++i)
+                {
+                    pendingMessages[priority].push(boundedQueue.pop());
+                }
+            }
+            if (waitingProducers)
+            {
+                spaceWait.notify_all();
+            }
         }
-        
-    };
+        hasQueuedMessages.store(!boundedQueues.empty(), std::memory_order_relaxed);
+    }
     
-    std::size_t missCounter { 0 };
+    /// @brief check without locking if other threads have placed messages on the main queue or a delayed message is due
+    inline bool getHasQueuedMessages() const noexcept
+    {
+        return hasQueuedMessages.load(std::memory_order_relaxed) || getIsDelayedMessageDue();
+    }
+    
+    /// @brief check without locking if the earliest delayed message is due
+    inline bool getIsDelayedMessageDue() const noexcept
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count() >= nextDelayedTime.load(std::memory_order_relaxed);
+    }
+    
+    /// @brief check if there are no messages on the main queue
+    /// @warning must be called while holding messageMutex
+    inline bool getIsQueueEmpty() const noexcept
+    {
+        return messageQueues.empty() && boundedQueues.empty();
+    }
+    
+    /// @brief wake up the run-loop (i.e. to notice it has been stopped) and any senders blocked on a full bounded queue
+    inline void wakeUp()
+    {
+        std::lock_guard<std::mutex> lock(messageMutex);
+        waitBackend->notify();
+        spaceWait.notify_all();
+    }
+    
+    /// @brief get next message from the mutex protected queue, waiting for one if there are none
+    /// @note all the pending messages are taken off the queue at once and up to maxBatchSize of them are processed without locking
+    std::unique_ptr<Message> getNextMessage()
+    {
+        // Once the batch is over the queue is only locked if other threads have sent something, so that messages the run-loop sends
+        // to itself are processed without locking
+        if (!pendingMessages.empty() && (batchCounter < maxBatchSize || !getHasQueuedMessages()))
+        {
+            ++batchCounter;
+            return std::unique_ptr<Message>(pendingMessages.pop());
+        }
+        batchCounter = 0;
+        if (pendingMessages.empty())
+        {
+            spinForMessages();
+            if (waitBackend->getHasReadyEvents())
+            {
+                // Descriptors became ready while spinning, they are dispatched by the run-loop before it waits
+                return nullptr;
+            }
+        }
+        const auto timeNow = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(messageMutex);
+            // Wait for any messages to arrive
+            if (pendingMessages.empty() && getIsQueueEmpty() && delayedQueue.empty() && getIsRunning())
+            {
+                // We wait for a new message to be pushed on any of the queues
+                isWaiting = true;
+                waitBackend->wait(lock, std::nullopt);
+                isWaiting = false;
+                noteWakeUp();
+            }
+            // Move delayed messages to main queue
+            if (!delayedQueue.empty())
+            {
+                if (!moveDelayedMessages(timeNow) && pendingMessages.empty() && getIsQueueEmpty() && getIsRunning())
+                {
+                    // If there are queued items but none were added to the queue wait till next queued item
+                    isWaiting = true;
+                    waitBackend->wait(lock, delayedQueue.getNextTime());
+                    isWaiting = false;
+                    noteWakeUp();
+                }
+            }
+            // Take all the messages from the main queue (or a batch of them from the bounded queue, so that the senders can move on)
+            takeMessages(maxBatchSize);
+        }
+        if (!pendingMessages.empty())
+        {
+            ++batchCounter;
+        }
+        return std::unique_ptr<Message>(pendingMessages.pop());
+    }
+    
+    /// @brief get next message from the lock-free queue, the mutex is only taken for delayed messages and for parking the thread
+    /// @note delayed messages are only looked at once every maxBatchSize messages
+    std::unique_ptr<Message> getNextLockFreeMessage()
+    {
+        if (batchCounter == 0 || batchCounter >= maxBatchSize)
+        {
+            batchCounter = 0;
+            const auto timeNow = std::chrono::steady_clock::now();
+            if (timeNow.time_since_epoch().count() >= nextDelayedTime.load(std::memory_order_relaxed))
+            {
+                std::lock_guard<std::mutex> lock(messageMutex);
+                moveDelayedMessages(timeNow);
+            }
+        }
+        if (auto next = std::unique_ptr<Message>(lockFreeQueues.pop()))
+        {
+            ++batchCounter;
+            return next;
+        }
+        batchCounter = 0;
+        if (!lockFreeQueues.empty())
+        {
+            // A producer is in the middle of a push
+            std::this_thread::yield();
+            return nullptr;
+        }
+        if (spinForMessages())
+        {
+            return nullptr;
+        }
+        std::unique_lock<std::mutex> lock(messageMutex);
+        // Announce that we're going to sleep before the final check, so that producers don't miss us
+        isWaiting = true;
+        if (lockFreeQueues.empty() && getIsRunning())
+        {
+            if (delayedQueue.empty())
+            {
+                waitBackend->wait(lock, std::nullopt);
+            }
+            else
+            {
+                waitBackend->wait(lock, delayedQueue.getNextTime());
+            }
+            noteWakeUp();
+        }
+        isWaiting = false;
+        return nullptr;
+    }
+    
+    /// @brief get next message from the per-producer queues, the mutex is only taken for delayed messages and for parking the thread
+    /// @note all the available messages are taken off the queues at once and up to maxBatchSize of them are processed before looking
+    /// at the queues and delayed messages again
+    std::unique_ptr<Message> getNextShardedMessage()
+    {
+        if (!pendingMessages.empty() && batchCounter < maxBatchSize)
+        {
+            ++batchCounter;
+            return std::unique_ptr<Message>(pendingMessages.pop());
+        }
+        batchCounter = 0;
+        const auto timeNow = std::chrono::steady_clock::now();
+        if (timeNow.time_since_epoch().count() >= nextDelayedTime.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(messageMutex);
+            moveDelayedMessages(timeNow);
+        }
+        takeShardedMessages();
+        if (!pendingMessages.empty())
+        {
+            ++batchCounter;
+            return std::unique_ptr<Message>(pendingMessages.pop());
+        }
+        if (!getIsShardedQueueEmpty())
+        {
+            // A producer is in the middle of a push
+            std::this_thread::yield();
+            return nullptr;
+        }
+        if (spinForMessages())
+        {
+            return nullptr;
+        }
+        std::unique_lock<std::mutex> lock(messageMutex);
+        // Announce that we're going to sleep before the final check, so that producers don't miss us
+        isWaiting = true;
+        if (getIsShardedQueueEmpty() && getIsRunning())
+        {
+            if (delayedQueue.empty())
+            {
+                waitBackend->wait(lock, std::nullopt);
+            }
+            else
+            {
+                waitBackend->wait(lock, delayedQueue.getNextTime());
+            }
+            noteWakeUp();
+        }
+        isWaiting = false;
+        return nullptr;
+    }
+    
+    /// @brief move the available messages of all the producers (and expired delayed messages) to the pending messages
+    /// @warning must only be called from the run-loop
+    inline void takeShardedMessages()
+    {
+        shardedQueues.drain(pendingMessages);
+        for (const auto priority : { Priority::High, Priority::Normal, Priority::Low })
+        {
+            while (auto message = lockFreeQueues[priority].pop())
+            {
+                pendingMessages[priority].push(message);
+            }
+        }
+    }
+    
+    /// @brief check if there are no messages on the per-producer queues or the expired delayed message queue
+    /// @warning must only be called from the run-loop
+    inline bool getIsShardedQueueEmpty()
+    {
+        return lockFreeQueues.empty() && shardedQueues.empty();
+    }
+    
+    /// @brief remove a delayed message from the delayed queue and destroy it
+    bool cancelDelayed(const TimerId& id)
+    {
+        std::unique_ptr<Message> message;
+        {
+            std::lock_guard<std::mutex> lock(messageMutex);
+            message = delayedQueue.cancel(id);
+            updateNextDelayedTime();
+        }
+        // Message is destroyed outside the lock as destructors of it's captures may want to send messages
+        return message != nullptr;
+    }
+    
+    /// @brief move a delayed message to a new timeout
+    bool rescheduleDelayed(const TimerId& id, const std::chrono::milliseconds& timeout)
+    {
+        std::lock_guard<std::mutex> lock(messageMutex);
+        if (delayedQueue.reschedule(id, std::chrono::steady_clock::now() + timeout))
+        {
+            updateNextDelayedTime();
+            if (isWaiting)
+            {
+                waitBackend->notify();
+            }
+            return true;
+        }
+        return false;
+    }
+    
+    /// @brief poll for incoming messages for a while before the run-loop parks the thread
+    /// @note the number of polls grows while it keeps catching messages and shrinks while it keeps ending up parked
+    /// @return true if a message arrived, a delayed message is due, a watched file descriptor is ready (or the thread was stopped)
+    /// while spinning
+    bool spinForMessages()
+    {
+        for (missCounter = 0; missCounter < spinLimit; ++missCounter)
+        {
+            const auto isYielding = missCounter >= spinLimit / 2;
+            if (isYielding && waitBackend->getIsWatching())
+            {
+                // Polling is a system call, so the descriptors are only polled in the yielding half of the spin
+                waitBackend->poll();
+            }
+            const auto hasIncoming = (queueType == QueueType::LockFree) ? !lockFreeQueues.empty()
+                : (queueType == QueueType::Sharded) ? !getIsShardedQueueEmpty()
+                : hasQueuedMessages.load(std::memory_order_relaxed);
+            if (hasIncoming || getIsDelayedMessageDue() || waitBackend->getHasReadyEvents() || !getIsRunning())
+            {
+                spinLimit = std::min(spinLimit * 2, spinCycles);
+                return true;
+            }
+            if (isYielding)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                cpuRelax();
+            }
+        }
+        spinLimit = std::max(spinLimit / 2, spinCycles / 8);
+        return false;
+    }
+    
+    static inline void cpuRelax() noexcept
+    {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+    
+    /// @brief move all the delayed messages that have timed out to the main queue
+    /// @warning must be called while holding messageMutex
+    /// @return true if any messages were moved
+    bool moveDelayedMessages(const std::chrono::time_point<std::chrono::steady_clock>& timeNow)
+    {
+        const auto hasNew = delayedQueue.expire(timeNow, [this](std::unique_ptr<Message>&& message){
+            noteQueued(*message);
+            if (queueType != QueueType::Locking)
+            {
+                // Sharded run-loop also drains the lock-free queue, so that expired messages don't need a shard of their own
+                lockFreeQueues[Priority::Normal].push(message.release());
+            }
+            else
+            {
+                messageQueues[Priority::Normal].push(message.release());
+            }
+        });
+        // Timer wheel may need to move far away timers closer, so the next time can change even if nothing has expired
+        updateNextDelayedTime();
+        return hasNew;
+    }
+    
+    /// @brief call the callbacks of the ready file descriptors, a busy run-loop polls for them every IoPollInterval messages
+    /// @param isBusy - the run-loop has just processed a message (it has not waited for the descriptors)
+    inline void dispatchIoEvents(bool isBusy)
+    {
+        if (isBusy && ++ioCounter >= IoPollInterval)
+        {
+            ioCounter = 0;
+            waitBackend->poll();
+        }
+        waitBackend->dispatch();
+    }
+    
+    /// @brief execute a message, measuring it if it has been sampled for statistics and recording it's trace events
+    inline void callMessage(Message& message)
+    {
+#if defined(THREADS_ENABLE_TRACING)
+        Tracer::record(TraceEventType::Dequeue, message.traceId, this);
+        Tracer::record(TraceEventType::Start, message.traceId, this);
+#endif
+#if defined(THREADS_ENABLE_STATISTICS)
+        if (message.enqueueTime != std::chrono::steady_clock::time_point{})
+        {
+            const auto startTime = std::chrono::steady_clock::now();
+            counters.recordLatency(startTime - message.enqueueTime);
+            message.call();
+            counters.recordExecutionTime(std::chrono::steady_clock::now() - startTime);
+        }
+        else
+        {
+            message.call();
+        }
+        counters.addExecuted();
+#else
+        message.call();
+#endif
+#if defined(THREADS_ENABLE_TRACING)
+        Tracer::record(TraceEventType::End, message.traceId, this);
+#endif
+    }
+    
+    /// @brief count messages placed on the queue and time stamp the first one if it's sampled
+    /// @note statistics methods are empty unless THREADS_ENABLE_STATISTICS is defined
+    inline void noteQueued([[maybe_unused]] Message& first, [[maybe_unused]] std::size_t count = 1) noexcept
+    {
+#if defined(THREADS_ENABLE_TRACING)
+        // Batches are still linked when they are counted, so every message gets it's own ID
+        auto message = &first;
+        for (std::size_t i = 0; i < count && message; ++i, message = message->next.load(std::memory_order_relaxed))
+        {
+            message->traceId = Tracer::getNextId();
+            Tracer::record(TraceEventType::Enqueue, message->traceId, this);
+        }
+#endif
+#if defined(THREADS_ENABLE_STATISTICS)
+        if (counters.addQueued(count))
+        {
+            first.enqueueTime = std::chrono::steady_clock::now();
+        }
+#endif
+    }
+    
+    inline void noteDropped() noexcept
+    {
+#if defined(THREADS_ENABLE_STATISTICS)
+        counters.addDropped();
+#endif
+    }
+    
+    inline void noteEvicted() noexcept
+    {
+#if defined(THREADS_ENABLE_STATISTICS)
+        counters.addEvicted();
+#endif
+    }
+    
+    inline void noteWakeUp() noexcept
+    {
+#if defined(THREADS_ENABLE_STATISTICS)
+        counters.addWakeUp();
+#endif
+    }
+    
+    /// @brief run-loop running on the calling thread
+    static inline Thread*& currentLoop() noexcept
+    {
+        thread_local Thread* loop { nullptr };
+        return loop;
+    }
+    
+    /// @brief publish the time of the earliest delayed message for the run-loops that check it without locking
+    /// @warning must be called while holding messageMutex
+    inline void updateNextDelayedTime() noexcept
+    {
+        nextDelayedTime.store(delayedQueue.getNextTime().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    
+    // Members are split in regions on separate cache lines by who writes them, so that the run-loop updating it's own state doesn't
+    // invalidate the cache lines producers read on every send
+    
+    // Configuration and state read by the producers on every send, only written when the thread is started or stopped
+    alignas(CacheLineSize) QueueType queueType { QueueType::Locking };
+    OverflowPolicy overflowPolicy { OverflowPolicy::Block };
+    std::size_t capacity { 0 };
     std::atomic<bool> isRunning { false };
     std::atomic<bool> isAcceptingMessages { true };
-    std::queue<std::unique_ptr<Message>> messageQueue;
-    std::map<std::chrono::time_point<std::chrono::steady_clock>, std::unique_ptr<Message>> delayedQueue;
-    std::unique_ptr<std::thread> thread;
-    std::condition_variable queueWait;
-    std::mutex messageMutex;
+    std::unique_ptr<NativeThread> thread;
+    
+    // State shared by the producers and the run-loop, mostly accessed while holding messageMutex
+    alignas(CacheLineSize) std::mutex messageMutex;
+    /// @brief what the run-loop blocks on while there are no messages
+    std::unique_ptr<WaitBackend> waitBackend { std::make_unique<ConditionWaitBackend>() };
+    /// @brief senders blocked on a full bounded queue wait on this
+    std::condition_variable spaceWait;
+    /// @brief number of senders blocked on a full bounded queue
+    std::size_t waitingProducers { 0 };
+    /// @brief set by the run-loop (while holding messageMutex) right before it parks, producers only notify when it's set
+    std::atomic<bool> isWaiting { false };
+    /// @brief set by producers of the locking queue, so that the run-loop can spin without taking the lock
+    std::atomic<bool> hasQueuedMessages { false };
+    std::atomic<std::chrono::steady_clock::rep> nextDelayedTime { std::numeric_limits<std::chrono::steady_clock::rep>::max() };
+    /// @brief every message queue has a separate lane per priority
+    PriorityLanes<IntrusiveQueue<Message>> messageQueues;
+    PriorityLanes<RingQueue<Message>> boundedQueues;
+    TimerWheel<std::unique_ptr<Message>> delayedQueue;
+    /// @brief how the run-loop finishes the leftover messages once it's stopped
+    ShutdownOptions shutdownOptions;
+    
+    // State accessed only by the run-loop
+    alignas(CacheLineSize) std::size_t maxBatchSize { 1 };
+    std::size_t batchCounter { 0 };
+    std::size_t spinCycles { 0 };
+    std::size_t spinLimit { 0 };
+    std::size_t missCounter { 0 };
+    /// @brief number of messages processed since the file descriptors were last polled
+    std::size_t ioCounter { 0 };
+    /// @brief messages taken off the messageQueues and messages the run-loop has sent to itself, accessed only by the run-loop
+    PriorityLanes<IntrusiveQueue<Message>> pendingMessages;
+    /// @brief leftover messages are dropped after this time (time_point::min() once it has passed)
+    std::chrono::steady_clock::time_point drainDeadline { std::chrono::steady_clock::time_point::max() };
+    /// @brief written by the run-loop when it finishes, read after the thread has been joined
+    ShutdownReport shutdownReport;
+    
+    // Lock-free queues keep their producer and consumer ends on separate cache lines themselves
+    alignas(CacheLineSize) PriorityLanes<MpscQueue<Message>> lockFreeQueues;
+    ShardedQueue<Message> shardedQueues;
+#if defined(THREADS_ENABLE_STATISTICS)
+    ThreadCounters counters;
+#endif
 };
 
 /// @brief Class representing a currently executing thread
@@ -371,6 +1389,19 @@ public:
         setIsRunning(true);
     }
     
+    /// @param initQueueType - type of the message queue to use for this thread
+    explicit ThisThread(QueueType initQueueType)
+        : ThisThread(ThreadOptions{initQueueType})
+    {}
+    
+    /// @param initOptions - thread configuration
+    explicit ThisThread(const ThreadOptions& initOptions)
+        : Thread(initOptions)
+    {
+        // ThisThread is already running
+        setIsRunning(true);
+    }
+    
     /// @brief start the thread and it's run-loop
     /// @warning calling this method will efectivelly block current thread
     void start() override
@@ -378,12 +1409,27 @@ public:
         runLoop();
     }
 
-    /// @brief signal the thread to stop - this also stops receiving messages
+    /// @brief apply start options to the current thread and start it's run-loop
+    /// @note stack size is ignored as the thread is already running
+    /// @warning calling this method will efectivelly block current thread
+    void start(const StartOptions& options) override
+    {
+        NativeThread::applyToCurrentThread(options);
+        if (options.numaNode >= 0)
+        {
+            reallocateQueues();
+        }
+        runLoop();
+    }
+
+    using Thread::stop;
+    
+    /// @brief signal the thread to stop and choose how it finishes the leftover messages - this also stops receiving messages
+    /// @param options - deadline for running the leftover messages and what happens to the delayed messages
     /// @warning if a message is sent after calling this method an exception will be thrown
-    void stop() override
+    void stop(const ShutdownOptions& options) override
     {
-        setIsAcceptingMessages(false);
-        setIsRunning(false);
+        requestStop(options);
     }
 };
     
@@ -0,0 +1,115 @@
+//
+//  ThreadGroup.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef ThreadGroup_hpp
+#define ThreadGroup_hpp
+
+#include "Thread.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace gusc::Threads
+{
+
+/// @brief group of threads that are stopped together
+/// Stopping threads one by one (i.e. by destroying them) waits for each thread to run all of it's leftover messages before the next
+/// thread is even signalled. A group signals all of it's threads first, so they drain their queues in parallel up to a common
+/// deadline, and only then joins them.
+/// @note the group doesn't own the threads, threads must outlive the group or be removed from it before they are destroyed
+/// @note this class is not thread safe
+class ThreadGroup
+{
+public:
+    ThreadGroup() = default;
+    /// @param initThreads - threads to add to the group
+    ThreadGroup(std::initializer_list<Thread*> initThreads)
+        : threads(initThreads)
+    {}
+
+    /// @brief add a thread to the group
+    /// @param thread - thread to add, a thread that is already in the group is not added again
+    inline void add(Thread* thread)
+    {
+        if (thread && std::find(threads.begin(), threads.end(), thread) == threads.end())
+        {
+            threads.push_back(thread);
+        }
+    }
+
+    /// @brief remove a thread from the group
+    /// @return false if the thread is not in the group
+    inline bool remove(Thread* thread) noexcept
+    {
+        const auto it = std::find(threads.begin(), threads.end(), thread);
+        if (it == threads.end())
+        {
+            return false;
+        }
+        threads.erase(it);
+        return true;
+    }
+
+    inline std::size_t size() const noexcept
+    {
+        return threads.size();
+    }
+
+    inline bool empty() const noexcept
+    {
+        return threads.empty();
+    }
+
+    /// @brief stop all the threads, wait until they have finished and collect what happened to their leftover messages
+    /// @param options - deadline for running the leftover messages and what happens to the delayed messages
+    /// @return reports of all the threads added up, returned delayed messages are ordered by thread and then by their timeouts
+    /// @note threads that have not been started (and ThisThread objects) are skipped
+    /// @warning must not be called from any of the group's threads, as a thread can't join itself
+    ShutdownReport shutdown(const ShutdownOptions& options = ShutdownOptions{})
+    {
+        for (const auto thread : threads)
+        {
+            if (thread->thread)
+            {
+                thread->requestStop(options);
+            }
+        }
+        ShutdownReport report;
+        for (const auto thread : threads)
+        {
+            if (thread->thread)
+            {
+                thread->join();
+                report.merge(thread->takeShutdownReport());
+            }
+        }
+        return report;
+    }
+
+    /// @brief stop all the threads, giving them a time limit for running their leftover messages
+    /// @param timeout - time counted from now after which leftover messages are dropped
+    /// @param delayedPolicy - what happens to the delayed messages
+    /// @return reports of all the threads added up
+    inline ShutdownReport shutdown(const std::chrono::milliseconds& timeout, DelayedMessagePolicy delayedPolicy = DelayedMessagePolicy::Discard)
+    {
+        ShutdownOptions options;
+        options.deadline = std::chrono::steady_clock::now() + timeout;
+        options.delayedPolicy = delayedPolicy;
+        return shutdown(options);
+    }
+
+private:
+    std::vector<Thread*> threads;
+};
+
+}
+
+#endif /* ThreadGroup_hpp */
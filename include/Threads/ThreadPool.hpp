@@ -0,0 +1,445 @@
+//
+//  ThreadPool.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include "Future.hpp"
+#include "IntrusiveQueue.hpp"
+#include "Message.hpp"
+#include "SyncSlot.hpp"
+#if defined(THREADS_ENABLE_TRACING)
+#   include "Tracing.hpp"
+#endif
+
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <future>
+
+namespace gusc::Threads
+{
+
+/// @brief Class representing a pool of worker threads sharing the work through work-stealing
+/// Every worker has it's own message queue, messages sent from outside of the pool are spread over the workers round-robin and
+/// messages sent from a worker are placed on that worker's own queue. A worker that runs out of messages steals half of the
+/// messages from another worker's queue, so one slow message does not hold up the rest of it's queue.
+/// @note messages are started in the order they were sent only when they end up on the same worker, there's no ordering across the pool
+class ThreadPool
+{
+public:
+    /// @param initWorkerCount - number of worker threads (0 - one per hardware thread)
+    explicit ThreadPool(std::size_t initWorkerCount = 0)
+    {
+        if (initWorkerCount == 0)
+        {
+            initWorkerCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        workers.reserve(initWorkerCount);
+        for (std::size_t i = 0; i < initWorkerCount; ++i)
+        {
+            workers.emplace_back(std::make_unique<Worker>(this, i));
+        }
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+    virtual ~ThreadPool()
+    {
+        setIsAcceptingMessages(false);
+        setIsRunning(false);
+        wakeUp();
+        join();
+    }
+
+    /// @brief start all the worker threads
+    virtual void start()
+    {
+        if (!getIsRunning())
+        {
+            setIsRunning(true);
+            for (auto& worker : workers)
+            {
+                worker->thread = std::make_unique<std::thread>(&ThreadPool::runLoop, this, std::ref(*worker));
+            }
+        }
+        else
+        {
+            throw std::runtime_error("Thread pool already started");
+        }
+    }
+
+    /// @brief signal all the worker threads to stop - this also stops receiving messages
+    /// @warning if a message is sent after calling this method an exception will be thrown
+    virtual void stop()
+    {
+        if (workers.front()->thread)
+        {
+            setIsAcceptingMessages(false);
+            setIsRunning(false);
+            wakeUp();
+        }
+        else
+        {
+            throw std::runtime_error("Thread pool has not been started");
+        }
+    }
+
+    /// @brief join all the worker threads and wait until they are finished
+    void join()
+    {
+        for (auto& worker : workers)
+        {
+            if (worker->thread && worker->thread->joinable())
+            {
+                worker->thread->join();
+            }
+        }
+    }
+
+    /// @brief send a message that needs to be executed on any of the worker threads
+    /// @param newMessage - any callable object that will be executed on the pool (temporaries and move-only callables are moved, not copied)
+    template<typename TCallable>
+    void send(TCallable&& newMessage)
+    {
+        if (getIsAcceptingMessages())
+        {
+            pushMessage(std::make_unique<CallableMessage<std::decay_t<TCallable>>>(std::forward<TCallable>(newMessage)));
+        }
+        else
+        {
+            throw std::runtime_error("Thread pool is not excepting any messages, the pool has been signaled for stopping");
+        }
+    }
+
+    /// @brief send an asynchronous message that returns value and needs to be executed on the pool (calling thread is not blocked)
+    /// @note if sent from one of the worker threads this method will call the callable immediatelly to prevent deadlocking
+    /// @param newMessage - any callable object that will be executed on the pool and it must return a value of type specified in TReturn (signature: TReturn(void))
+    template<typename TReturn, typename TCallable>
+    std::future<TReturn> sendAsync(TCallable&& newMessage)
+    {
+        if (getIsAcceptingMessages())
+        {
+            std::promise<TReturn> promise;
+            std::future<TReturn> future = promise.get_future();
+            auto message = std::make_unique<CallableMessageWithPromise<TReturn, std::decay_t<TCallable>>>(std::forward<TCallable>(newMessage), std::move(promise));
+            if (getIsSameThread())
+            {
+                // If we are on one of the workers excute message immediatelly to prent a deadlock
+                message->call();
+            }
+            else
+            {
+                pushMessage(std::move(message));
+            }
+            return future;
+        }
+        else
+        {
+            throw std::runtime_error("Thread pool is not excepting any messages, the pool has been signaled for stopping");
+        }
+    }
+
+    /// @brief send an asynchronous message that returns value and needs to be executed on the pool, the result can be continued on another thread
+    /// @note if sent from one of the worker threads this method will call the callable immediatelly to prevent deadlocking
+    /// @param newMessage - any callable object that will be executed on the pool and it must return a value of type specified in TReturn (signature: TReturn(void)), exceptions are passed to the future
+    template<typename TReturn, typename TCallable>
+    Future<TReturn> sendFuture(TCallable&& newMessage)
+    {
+        if (getIsAcceptingMessages())
+        {
+            Promise<TReturn> promise;
+            auto future = promise.getFuture();
+            if (getIsSameThread())
+            {
+                // If we are on one of the workers excute message immediatelly to prent a deadlock
+                promise.fulfill(std::forward<TCallable>(newMessage));
+            }
+            else
+            {
+                auto message = [promise = std::move(promise), callable = std::forward<TCallable>(newMessage)]() mutable {
+                    promise.fulfill(callable);
+                };
+                pushMessage(std::make_unique<CallableMessage<decltype(message)>>(std::move(message)));
+            }
+            return future;
+        }
+        else
+        {
+            throw std::runtime_error("Thread pool is not excepting any messages, the pool has been signaled for stopping");
+        }
+    }
+
+    /// @brief send a synchronous message that returns value and needs to be executed on the pool (calling thread is blocked until message returns)
+    /// @note to prevent deadlocking this method throws exception if called before the pool has started
+    /// @param newMessage - any callable object that will be executed on the pool and it must return a value of type specified in TReturn (signature: TReturn(void))
+    /// @throws the exception thrown by the callable, std::future_error with broken_promise if the message is discarded without being called
+    template<typename TReturn, typename TCallable>
+    TReturn sendSync(TCallable&& newMessage)
+    {
+        if (!getIsRunning())
+        {
+            throw std::runtime_error("Can not place a blocking message if the thread pool is not started");
+        }
+        if (!getIsAcceptingMessages())
+        {
+            throw std::runtime_error("Thread pool is not excepting any messages, the pool has been signaled for stopping");
+        }
+        if (getIsSameThread())
+        {
+            // If we are on one of the workers execute the message immediately to prevent a deadlock
+            // Callable is copied, so that callables with a non-const call operator can be passed as const references
+            std::decay_t<TCallable> callable(std::forward<TCallable>(newMessage));
+            if constexpr (std::is_void_v<TReturn>)
+            {
+                callable();
+                return;
+            }
+            else
+            {
+                return callable();
+            }
+        }
+        // Result is passed back through a slot on this stack instead of a std::promise
+        SyncSlot<TReturn> slot;
+        pushMessage(std::make_unique<SyncMessage<TReturn, std::decay_t<TCallable>>>(std::forward<TCallable>(newMessage), slot));
+        return slot.take();
+    }
+
+    /// @brief send a message that needs to be executed on the pool and wait for it's completion
+    /// @param newMessage - any callable object that will be executed on the pool
+    template<typename TCallable>
+    void sendWait(TCallable&& newMessage)
+    {
+        sendSync<void>(std::forward<TCallable>(newMessage));
+    }
+
+    inline std::size_t getWorkerCount() const noexcept
+    {
+        return workers.size();
+    }
+
+    /// @brief check if a thread is one of the worker threads of this pool
+    inline bool operator==(const std::thread::id& other) const noexcept
+    {
+        if (other == std::this_thread::get_id())
+        {
+            return getIsSameThread();
+        }
+        return std::any_of(workers.begin(), workers.end(), [&other](const std::unique_ptr<Worker>& worker){
+            return worker->thread && worker->thread->get_id() == other;
+        });
+    }
+    inline bool operator!=(const std::thread::id& other) const noexcept
+    {
+        return !(operator==(other));
+    }
+
+protected:
+    inline bool getIsRunning() const noexcept
+    {
+        return isRunning;
+    }
+
+    inline void setIsRunning(bool newIsRunning) noexcept
+    {
+        isRunning = newIsRunning;
+    }
+
+    inline bool getIsAcceptingMessages() const noexcept
+    {
+        return isAcceptingMessages;
+    }
+
+    inline void setIsAcceptingMessages(bool newIsAcceptingMessages) noexcept
+    {
+        isAcceptingMessages = newIsAcceptingMessages;
+    }
+
+    /// @brief check if the calling thread is one of the worker threads of this pool
+    inline bool getIsSameThread() const noexcept
+    {
+        return currentWorker() && currentWorker()->pool == this;
+    }
+
+private:
+    /// @brief worker thread and it's message queue, kept on separate cache lines as queues are locked by other workers when stealing
+    struct alignas(CacheLineSize) Worker
+    {
+        Worker(ThreadPool* initPool, std::size_t initIndex)
+            : pool(initPool)
+            , index(initIndex)
+        {}
+
+        ThreadPool* pool { nullptr };
+        std::size_t index { 0 };
+        std::mutex queueMutex;
+        IntrusiveQueue<Message> messageQueue;
+        std::unique_ptr<std::thread> thread;
+    };
+
+    void runLoop(Worker& worker)
+    {
+        currentWorker() = &worker;
+        while (getIsRunning())
+        {
+            if (auto next = getNextMessage(worker))
+            {
+                callMessage(*next);
+            }
+            else
+            {
+                park();
+            }
+        }
+        // Process any leftover messages
+        while (auto next = getNextMessage(worker))
+        {
+            callMessage(*next);
+        }
+        currentWorker() = nullptr;
+    }
+    
+    /// @brief execute a message recording it's trace events
+    /// @note trace events are only recorded if THREADS_ENABLE_TRACING is defined
+    inline void callMessage(Message& message)
+    {
+#if defined(THREADS_ENABLE_TRACING)
+        Tracer::record(TraceEventType::Dequeue, message.traceId, this);
+        Tracer::record(TraceEventType::Start, message.traceId, this);
+        message.call();
+        Tracer::record(TraceEventType::End, message.traceId, this);
+#else
+        message.call();
+#endif
+    }
+
+    /// @brief place a message on the current worker's queue or on the next worker's queue and wake up a worker if necessary
+    inline void pushMessage(std::unique_ptr<Message> message)
+    {
+        Worker* worker = getIsSameThread() ? currentWorker() : nullptr;
+        if (!worker)
+        {
+            worker = workers[nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size()].get();
+        }
+#if defined(THREADS_ENABLE_TRACING)
+        message->traceId = Tracer::getNextId();
+        Tracer::record(TraceEventType::Enqueue, message->traceId, this);
+#endif
+        // Count the message before it's visible, so that a worker that is about to park can't miss it
+        pendingCount.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(worker->queueMutex);
+            worker->messageQueue.push(message.release());
+        }
+        // Only workers that have announced they're going to sleep need a notification
+        if (sleepingCount.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            parkWait.notify_one();
+        }
+    }
+
+    /// @brief wake up all the workers (i.e. to notice the pool has been stopped)
+    inline void wakeUp()
+    {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        parkWait.notify_all();
+    }
+
+    /// @brief get next message from the worker's own queue or steal it from other workers
+    /// @return message or nullptr if there are no messages on any of the queues
+    std::unique_ptr<Message> getNextMessage(Worker& worker)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker.queueMutex);
+            if (auto next = std::unique_ptr<Message>(worker.messageQueue.pop()))
+            {
+                pendingCount.fetch_sub(1, std::memory_order_relaxed);
+                return next;
+            }
+        }
+        return stealMessage(worker);
+    }
+
+    /// @brief take half of the messages of the first worker that has any, starting with the next worker after the thief
+    /// @return first stolen message, the rest of them are placed on the thief's queue
+    std::unique_ptr<Message> stealMessage(Worker& thief)
+    {
+        for (std::size_t i = 1; i < workers.size(); ++i)
+        {
+            auto& victim = *workers[(thief.index + i) % workers.size()];
+            IntrusiveQueue<Message> stolen;
+            {
+                std::lock_guard<std::mutex> lock(victim.queueMutex);
+                stolen.splice(victim.messageQueue, (victim.messageQueue.size() + 1) / 2);
+            }
+            if (auto next = std::unique_ptr<Message>(stolen.pop()))
+            {
+                if (!stolen.empty())
+                {
+                    // Queues are never locked together, so that thieves can't deadlock each other
+                    std::lock_guard<std::mutex> lock(thief.queueMutex);
+                    thief.messageQueue.splice(stolen);
+                }
+                pendingCount.fetch_sub(1, std::memory_order_relaxed);
+                return next;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief park the calling worker until a message is sent or the pool is stopped
+    void park()
+    {
+        std::unique_lock<std::mutex> lock(parkMutex);
+        // Announce that we're going to sleep before the final check, so that producers don't miss us
+        sleepingCount.fetch_add(1);
+        const auto isIdle = pendingCount.load() == 0 && getIsRunning();
+        if (isIdle)
+        {
+            parkWait.wait(lock);
+        }
+        sleepingCount.fetch_sub(1);
+        if (!isIdle)
+        {
+            // A producer is in the middle of a push
+            lock.unlock();
+            std::this_thread::yield();
+        }
+    }
+
+    static inline Worker*& currentWorker() noexcept
+    {
+        thread_local Worker* worker { nullptr };
+        return worker;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> isRunning { false };
+    std::atomic<bool> isAcceptingMessages { true };
+    std::atomic<std::size_t> nextWorker { 0 };
+    /// @brief number of messages on all the worker queues (counted before they're pushed)
+    std::atomic<std::size_t> pendingCount { 0 };
+    /// @brief number of workers that are parked or about to park
+    std::atomic<std::size_t> sleepingCount { 0 };
+    std::condition_variable parkWait;
+    std::mutex parkMutex;
+};
+
+}
+
+#endif /* ThreadPool_hpp */
@@ -0,0 +1,423 @@
+//
+//  TimerWheel.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef TimerWheel_hpp
+#define TimerWheel_hpp
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace gusc::Threads
+{
+
+/// @brief identifier of a timer in a TimerWheel - stays unique even after the timer's node is reused
+struct TimerId
+{
+    std::uint32_t index { std::numeric_limits<std::uint32_t>::max() };
+    std::uint32_t generation { 0 };
+};
+
+/// @brief hierarchical timer wheel with millisecond resolution
+/// Timers are kept in pooled nodes linked into one of 64 slots on each of 4 levels (covering ~4.6 hours, anything further away waits
+/// on an overflow list), so inserting and removing a timer is O(1) and does not allocate once the pool has grown.
+/// Any number of timers can share the same deadline, timers expiring on the same millisecond are expired in insertion order.
+/// Timers can be cancelled or rescheduled in O(1) through the TimerId returned on insertion.
+/// @note this class is not thread safe
+template<typename TPayload>
+class TimerWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    explicit TimerWheel(const TimePoint& initStartTime = Clock::now())
+        : startTime(initStartTime)
+    {}
+
+    /// @brief add a timer
+    /// @param deadline - time after which the timer expires
+    /// @param payload - data that is handed out when the timer expires
+    /// @return timer identifier for cancelling or rescheduling the timer
+    inline TimerId insert(const TimePoint& deadline, TPayload payload)
+    {
+        const auto index = allocateNode();
+        auto& node = nodes[index];
+        node.tick = getTick(deadline);
+        node.payload = std::move(payload);
+        place(index);
+        ++count;
+        return TimerId{index, node.generation};
+    }
+
+    /// @brief remove a timer before it has expired
+    /// @param id - timer identifier returned by insert()
+    /// @return payload of the timer or default constructed payload if the timer is not in the wheel anymore
+    inline TPayload cancel(const TimerId& id)
+    {
+        if (!getIsActive(id))
+        {
+            return TPayload{};
+        }
+        unlink(id.index);
+        --count;
+        auto payload = std::move(nodes[id.index].payload);
+        freeNode(id.index);
+        return payload;
+    }
+
+    /// @brief move a timer to a new deadline
+    /// @param id - timer identifier returned by insert()
+    /// @param deadline - new time after which the timer expires
+    /// @return false if the timer is not in the wheel anymore
+    inline bool reschedule(const TimerId& id, const TimePoint& deadline) noexcept
+    {
+        if (!getIsActive(id))
+        {
+            return false;
+        }
+        unlink(id.index);
+        nodes[id.index].tick = getTick(deadline);
+        place(id.index);
+        return true;
+    }
+
+    /// @brief expire all the timers that are due at given time
+    /// @param timeNow - current time
+    /// @param callback - function that receives the payload of every expired timer (signature: void(TPayload&&))
+    /// @return true if any timers expired
+    template<typename TCallback>
+    bool expire(const TimePoint& timeNow, TCallback&& callback)
+    {
+        advance(timeNow < startTime ? 0 : static_cast<std::uint64_t>(std::chrono::duration_cast<Resolution>(timeNow - startTime).count()));
+        const auto hasExpired = lists[DueList].first != InvalidIndex;
+        while (lists[DueList].first != InvalidIndex)
+        {
+            const auto index = lists[DueList].first;
+            unlink(index);
+            --count;
+            auto payload = std::move(nodes[index].payload);
+            freeNode(index);
+            callback(std::move(payload));
+        }
+        return hasExpired;
+    }
+
+    /// @brief remove all the timers in the order of their deadlines
+    /// @param callback - function that receives the deadline (rounded up to the wheel's resolution) and the payload of every timer
+    /// (signature: void(const TimePoint&, TPayload&&))
+    template<typename TCallback>
+    void drain(TCallback&& callback)
+    {
+        while (count != 0)
+        {
+            if (lists[DueList].first == InvalidIndex)
+            {
+                // Advance only up to the next event, so that the wheel can still be used afterwards
+                advance(getNextEventTick());
+            }
+            while (lists[DueList].first != InvalidIndex)
+            {
+                const auto index = lists[DueList].first;
+                unlink(index);
+                --count;
+                const auto deadline = startTime + Resolution(nodes[index].tick);
+                auto payload = std::move(nodes[index].payload);
+                freeNode(index);
+                callback(deadline, std::move(payload));
+            }
+        }
+    }
+
+    /// @brief get the time when expire() should be called next
+    /// @note this can be earlier than the actual deadline of the next timer (time when far away timers need to be moved closer)
+    /// @return time point or TimePoint::max() if there are no timers
+    inline TimePoint getNextTime() const noexcept
+    {
+        if (lists[DueList].first != InvalidIndex)
+        {
+            return startTime;
+        }
+        const auto tick = getNextEventTick();
+        if (tick == NoTick)
+        {
+            return TimePoint::max();
+        }
+        return startTime + Resolution(tick);
+    }
+
+    inline bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    inline std::size_t size() const noexcept
+    {
+        return count;
+    }
+
+private:
+    using Resolution = std::chrono::milliseconds;
+    static constexpr const std::uint32_t InvalidIndex { std::numeric_limits<std::uint32_t>::max() };
+    static constexpr const std::uint64_t NoTick { std::numeric_limits<std::uint64_t>::max() };
+    static constexpr const std::size_t SlotBits { 6 };
+    static constexpr const std::size_t SlotCount { 1 << SlotBits };
+    static constexpr const std::size_t LevelCount { 4 };
+    static constexpr const std::size_t DueList { LevelCount * SlotCount };
+    static constexpr const std::size_t OverflowList { DueList + 1 };
+
+    struct Node
+    {
+        std::uint64_t tick { 0 };
+        TPayload payload {};
+        std::uint32_t prev { InvalidIndex };
+        std::uint32_t next { InvalidIndex };
+        std::uint32_t list { InvalidIndex };
+        std::uint32_t generation { 0 };
+    };
+
+    struct List
+    {
+        std::uint32_t first { InvalidIndex };
+        std::uint32_t last { InvalidIndex };
+    };
+
+    TimePoint startTime;
+    /// @brief last tick that has been processed, all the timers up to and including this tick are on the due list
+    std::uint64_t currentTick { 0 };
+    std::size_t count { 0 };
+    std::vector<Node> nodes;
+    std::uint32_t freeNodes { InvalidIndex };
+    std::array<List, OverflowList + 1> lists;
+    std::array<std::uint64_t, LevelCount> occupied {};
+
+    inline std::uint64_t getTick(const TimePoint& deadline) const noexcept
+    {
+        if (deadline <= startTime)
+        {
+            return 0;
+        }
+        // Round up so that timers never expire early
+        const auto delta = deadline - startTime;
+        auto tick = std::chrono::duration_cast<Resolution>(delta);
+        if (tick < delta)
+        {
+            ++tick;
+        }
+        return static_cast<std::uint64_t>(tick.count());
+    }
+
+    inline std::uint32_t allocateNode()
+    {
+        if (freeNodes != InvalidIndex)
+        {
+            const auto index = freeNodes;
+            freeNodes = nodes[index].next;
+            nodes[index].next = InvalidIndex;
+            return index;
+        }
+        nodes.emplace_back();
+        return static_cast<std::uint32_t>(nodes.size() - 1);
+    }
+
+    inline bool getIsActive(const TimerId& id) const noexcept
+    {
+        return id.index < nodes.size()
+            && nodes[id.index].generation == id.generation
+            && nodes[id.index].list != InvalidIndex;
+    }
+
+    inline void freeNode(std::uint32_t index) noexcept
+    {
+        auto& node = nodes[index];
+        node.payload = TPayload{};
+        // Invalidate all the identifiers pointing to this node
+        ++node.generation;
+        node.next = freeNodes;
+        freeNodes = index;
+    }
+
+    /// @brief link a node into the list where it belongs relative to the current tick
+    inline void place(std::uint32_t index) noexcept
+    {
+        const auto tick = nodes[index].tick;
+        if (tick <= currentTick)
+        {
+            link(index, DueList);
+            return;
+        }
+        // Level is chosen by the highest group of bits that differs from the current tick, this way a node is always in a slot
+        // ahead of the current position on it's level and it's moved down a level when the current tick reaches that slot
+        const auto level = static_cast<std::size_t>(getHighestBit(tick ^ currentTick) / SlotBits);
+        if (level >= LevelCount)
+        {
+            link(index, OverflowList);
+        }
+        else
+        {
+            link(index, level * SlotCount + ((tick >> (level * SlotBits)) & (SlotCount - 1)));
+        }
+    }
+
+    inline void link(std::uint32_t index, std::size_t listIndex) noexcept
+    {
+        auto& node = nodes[index];
+        auto& list = lists[listIndex];
+        node.list = static_cast<std::uint32_t>(listIndex);
+        node.prev = list.last;
+        node.next = InvalidIndex;
+        if (list.last != InvalidIndex)
+        {
+            nodes[list.last].next = index;
+        }
+        else
+        {
+            list.first = index;
+        }
+        list.last = index;
+        if (listIndex < DueList)
+        {
+            occupied[listIndex / SlotCount] |= std::uint64_t(1) << (listIndex % SlotCount);
+        }
+    }
+
+    inline void unlink(std::uint32_t index) noexcept
+    {
+        auto& node = nodes[index];
+        auto& list = lists[node.list];
+        if (node.prev != InvalidIndex)
+        {
+            nodes[node.prev].next = node.next;
+        }
+        else
+        {
+            list.first = node.next;
+        }
+        if (node.next != InvalidIndex)
+        {
+            nodes[node.next].prev = node.prev;
+        }
+        else
+        {
+            list.last = node.prev;
+        }
+        if (node.list < DueList && list.first == InvalidIndex)
+        {
+            occupied[node.list / SlotCount] &= ~(std::uint64_t(1) << (node.list % SlotCount));
+        }
+        node.prev = InvalidIndex;
+        node.next = InvalidIndex;
+        node.list = InvalidIndex;
+    }
+
+    /// @brief re-place all the nodes of a list relative to the current tick
+    inline void cascade(std::size_t listIndex) noexcept
+    {
+        // Detach the whole list first, as nodes of the overflow list can end up on it again
+        auto index = lists[listIndex].first;
+        lists[listIndex] = List{};
+        if (listIndex < DueList)
+        {
+            occupied[listIndex / SlotCount] &= ~(std::uint64_t(1) << (listIndex % SlotCount));
+        }
+        while (index != InvalidIndex)
+        {
+            const auto next = nodes[index].next;
+            place(index);
+            index = next;
+        }
+    }
+
+    /// @brief get the first tick at which a node has to be expired or moved to a lower level
+    inline std::uint64_t getNextEventTick() const noexcept
+    {
+        auto nextTick = NoTick;
+        for (std::size_t level = 0; level < LevelCount; ++level)
+        {
+            if (occupied[level])
+            {
+                // All the nodes of a level are in slots ahead of the current tick, so the lowest occupied slot is the next one
+                const auto shift = level * SlotBits;
+                const auto base = (currentTick >> (shift + SlotBits)) << (shift + SlotBits);
+                const auto tick = base | (static_cast<std::uint64_t>(getLowestBit(occupied[level])) << shift);
+                nextTick = std::min(nextTick, tick);
+            }
+        }
+        if (lists[OverflowList].first != InvalidIndex)
+        {
+            constexpr const auto shift = LevelCount * SlotBits;
+            nextTick = std::min(nextTick, ((currentTick >> shift) + 1) << shift);
+        }
+        return nextTick;
+    }
+
+    /// @brief move the current tick forward, jumping straight to the ticks where something happens
+    inline void advance(std::uint64_t tick) noexcept
+    {
+        while (currentTick < tick)
+        {
+            const auto nextTick = getNextEventTick();
+            if (nextTick > tick)
+            {
+                currentTick = tick;
+                break;
+            }
+            currentTick = nextTick;
+            if ((currentTick & ((std::uint64_t(1) << (LevelCount * SlotBits)) - 1)) == 0)
+            {
+                cascade(OverflowList);
+            }
+            for (auto level = LevelCount - 1; level > 0; --level)
+            {
+                const auto shift = level * SlotBits;
+                if ((currentTick & ((std::uint64_t(1) << shift) - 1)) == 0)
+                {
+                    cascade(level * SlotCount + ((currentTick >> shift) & (SlotCount - 1)));
+                }
+            }
+            cascade(currentTick & (SlotCount - 1));
+        }
+    }
+
+    static inline std::size_t getHighestBit(std::uint64_t value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(63 - __builtin_clzll(value));
+#else
+        std::size_t bit { 0 };
+        while (value >>= 1)
+        {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    static inline std::size_t getLowestBit(std::uint64_t value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctzll(value));
+#else
+        std::size_t bit { 0 };
+        while (!(value & 1))
+        {
+            value >>= 1;
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+};
+
+}
+
+#endif /* TimerWheel_hpp */
@@ -0,0 +1,429 @@
+//
+//  Tracing.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef Tracing_hpp
+#define Tracing_hpp
+
+#include "MessagePool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+#   include <pthread.h>
+#endif
+
+#ifndef THREADS_TRACE_BUFFER_SIZE
+/// @brief number of events every thread keeps, older events are overwritten (must be a power of 2)
+#   define THREADS_TRACE_BUFFER_SIZE 65536
+#endif
+
+namespace gusc::Threads
+{
+
+enum class TraceEventType : std::uint8_t
+{
+    /// @brief message placed on a thread's queue (recorded on the sending thread)
+    Enqueue,
+    /// @brief message taken off the queue by the run-loop
+    Dequeue,
+    /// @brief message started
+    Start,
+    /// @brief message finished
+    End,
+    /// @brief signal emitted (recorded on the emitting thread)
+    Emit,
+    /// @brief signal listener called (recorded on the listener's thread)
+    Deliver
+};
+
+/// @brief single recorded event
+struct TraceEvent
+{
+    /// @brief raw time stamp in ticks of getTraceTimestamp()
+    std::uint64_t timestamp { 0 };
+    /// @brief message ID or emission ID of signal events
+    std::uint64_t id { 0 };
+    /// @brief thread the message was sent to or the signal that was emitted
+    const void* object { nullptr };
+    TraceEventType type { TraceEventType::Enqueue };
+};
+
+/// @brief get a time stamp for a trace event
+/// @note uses the time stamp counter (TSC) on x86 and the virtual counter on ARM64, so the ticks are not nanoseconds, Tracer
+/// calibrates them against std::chrono::steady_clock when the trace is written
+inline std::uint64_t getTraceTimestamp() noexcept
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/// @brief ring buffer of the trace events of one thread
+/// Only the owning thread records events, so recording is a few relaxed stores and a release store of the write index. Events are
+/// stored in atomics, so the buffer can be read from any thread while it's being written.
+/// @note events that are being overwritten while the buffer is read can be inconsistent, the trace should be written once the
+/// traced work is done
+class TraceBuffer
+{
+public:
+    static constexpr const std::size_t Capacity { THREADS_TRACE_BUFFER_SIZE };
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "THREADS_TRACE_BUFFER_SIZE must be a power of 2");
+
+    TraceBuffer(std::uint32_t initThreadIndex, std::string initName)
+        : threadIndex(initThreadIndex)
+        , name(std::move(initName))
+        , entries(std::make_unique<Entry[]>(Capacity))
+    {}
+
+    inline void record(TraceEventType type, std::uint64_t id, const void* object) noexcept
+    {
+        const auto index = writeIndex.load(std::memory_order_relaxed);
+        auto& entry = entries[index & (Capacity - 1)];
+        entry.timestamp.store(getTraceTimestamp(), std::memory_order_relaxed);
+        entry.id.store(id, std::memory_order_relaxed);
+        entry.object.store(object, std::memory_order_relaxed);
+        entry.type.store(type, std::memory_order_relaxed);
+        writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    /// @brief copy the events recorded since the last clear() (at most Capacity of the latest ones)
+    std::vector<TraceEvent> getEvents() const
+    {
+        const auto end = writeIndex.load(std::memory_order_acquire);
+        auto begin = std::max(end > Capacity ? end - Capacity : 0, clearIndex.load(std::memory_order_relaxed));
+        std::vector<TraceEvent> events;
+        events.reserve(static_cast<std::size_t>(end - begin));
+        for (auto index = begin; index < end; ++index)
+        {
+            const auto& entry = entries[index & (Capacity - 1)];
+            events.push_back({
+                entry.timestamp.load(std::memory_order_relaxed),
+                entry.id.load(std::memory_order_relaxed),
+                entry.object.load(std::memory_order_relaxed),
+                entry.type.load(std::memory_order_relaxed)
+            });
+        }
+        // Drop the oldest events if the owner has wrapped around while they were copied
+        const auto written = writeIndex.load(std::memory_order_acquire);
+        if (written - begin > Capacity)
+        {
+            const auto overwritten = std::min<std::size_t>(static_cast<std::size_t>(written - begin - Capacity), events.size());
+            events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(overwritten));
+        }
+        return events;
+    }
+
+    /// @brief forget all the recorded events
+    inline void clear() noexcept
+    {
+        clearIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+    inline std::uint32_t getThreadIndex() const noexcept
+    {
+        return threadIndex;
+    }
+
+    inline const std::string& getName() const noexcept
+    {
+        return name;
+    }
+
+private:
+    struct Entry
+    {
+        std::atomic<std::uint64_t> timestamp { 0 };
+        std::atomic<std::uint64_t> id { 0 };
+        std::atomic<const void*> object { nullptr };
+        std::atomic<TraceEventType> type { TraceEventType::Enqueue };
+    };
+
+    const std::uint32_t threadIndex { 0 };
+    const std::string name;
+    std::unique_ptr<Entry[]> entries;
+    /// @brief written only by the owning thread
+    alignas(CacheLineSize) std::atomic<std::uint64_t> writeIndex { 0 };
+    std::atomic<std::uint64_t> clearIndex { 0 };
+};
+
+/// @brief collects the trace events of all the threads and writes them in the Chrome trace event format
+/// The written JSON can be opened in ui.perfetto.dev or chrome://tracing - every thread gets a track with slices for the messages it
+/// executed, flow arrows from where the messages were sent and instant events for the signal emissions and deliveries, with flow
+/// arrows from every emission to the listener calls it caused.
+/// @note the buffers of threads that have exited are kept until clear() is called
+class Tracer
+{
+public:
+    /// @brief record an event on the calling thread's buffer (the buffer is created on the first call from every thread)
+    static inline void record(TraceEventType type, std::uint64_t id, const void* object) noexcept
+    {
+        if (auto buffer = getLocalBuffer())
+        {
+            buffer->record(type, id, object);
+        }
+    }
+
+    /// @brief get a new message or emission ID, it's used to connect the enqueue and the execution events of a message or the
+    /// emission and the delivery events of a signal
+    static inline std::uint64_t getNextId() noexcept
+    {
+        return getRegistry().nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief forget all the recorded events and the buffers of threads that have exited
+    static void clear()
+    {
+        auto& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto it = registry.buffers.begin(); it != registry.buffers.end();)
+        {
+            if (it->use_count() == 1)
+            {
+                it = registry.buffers.erase(it);
+            }
+            else
+            {
+                (*it)->clear();
+                ++it;
+            }
+        }
+    }
+
+    /// @brief write the recorded events of all the threads as Chrome trace event format JSON
+    static void writeChromeTrace(std::ostream& stream)
+    {
+        auto& registry = getRegistry();
+        std::vector<std::pair<std::shared_ptr<TraceBuffer>, std::vector<TraceEvent>>> threads;
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (const auto& buffer : registry.buffers)
+            {
+                threads.emplace_back(buffer, buffer->getEvents());
+            }
+        }
+        // Calibrate the ticks against the steady clock over the time since the first buffer was created
+        const auto ticks = getTraceTimestamp();
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsedTicks = static_cast<double>(ticks - registry.baseTicks);
+        const auto elapsedTime = std::chrono::duration<double, std::micro>(now - registry.baseTime).count();
+        const auto microsecondsPerTick = (elapsedTicks > 0.0) ? elapsedTime / elapsedTicks : 0.0;
+        const auto getMicroseconds = [&registry, microsecondsPerTick](std::uint64_t timestamp){
+            return static_cast<double>(static_cast<std::int64_t>(timestamp - registry.baseTicks)) * microsecondsPerTick;
+        };
+        std::unordered_map<std::uint64_t, std::uint64_t> enqueueTimes;
+        // Every delivery gets it's own flow from the emission, numbered in the order the deliveries are written
+        std::unordered_map<std::uint64_t, std::vector<std::uint64_t>> emissionFlows;
+        for (const auto& thread : threads)
+        {
+            for (const auto& event : thread.second)
+            {
+                if (event.type == TraceEventType::Enqueue)
+                {
+                    enqueueTimes[event.id] = event.timestamp;
+                }
+                else if (event.type == TraceEventType::Emit)
+                {
+                    emissionFlows[event.id];
+                }
+            }
+        }
+        std::uint64_t flowCount { 0 };
+        for (const auto& thread : threads)
+        {
+            for (const auto& event : thread.second)
+            {
+                if (event.type == TraceEventType::Deliver)
+                {
+                    const auto flows = emissionFlows.find(event.id);
+                    if (flows != emissionFlows.end())
+                    {
+                        flows->second.push_back(++flowCount);
+                    }
+                }
+            }
+        }
+        flowCount = 0;
+
+        const auto flags = stream.flags();
+        const auto precision = stream.precision();
+        stream << std::fixed << std::setprecision(3);
+        stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool isFirst { true };
+        const auto beginEvent = [&stream, &isFirst](const char* name, const char* phase, std::uint32_t threadIndex){
+            stream << (isFirst ? "\n" : ",\n") << "{\"name\":\"" << name << "\",\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << threadIndex;
+            isFirst = false;
+        };
+        for (const auto& thread : threads)
+        {
+            const auto threadIndex = thread.first->getThreadIndex();
+            beginEvent("thread_name", "M", threadIndex);
+            stream << ",\"args\":{\"name\":";
+            writeString(stream, thread.first->getName().empty() ? "Thread " + std::to_string(threadIndex) : thread.first->getName());
+            stream << "}}";
+            for (const auto& event : thread.second)
+            {
+                const auto time = getMicroseconds(event.timestamp);
+                switch (event.type)
+                {
+                    case TraceEventType::Enqueue:
+                        beginEvent("enqueue", "i", threadIndex);
+                        stream << ",\"s\":\"t\",\"ts\":" << time << ",\"args\":{\"id\":" << event.id << ",\"thread\":\"" << event.object << "\"}}";
+                        beginEvent("message", "s", threadIndex);
+                        stream << ",\"cat\":\"message\",\"id\":" << event.id << ",\"ts\":" << time << "}";
+                        break;
+                    case TraceEventType::Dequeue:
+                        beginEvent("dequeue", "i", threadIndex);
+                        stream << ",\"s\":\"t\",\"ts\":" << time << ",\"args\":{\"id\":" << event.id << "}}";
+                        break;
+                    case TraceEventType::Start:
+                    {
+                        beginEvent("message", "B", threadIndex);
+                        stream << ",\"cat\":\"message\",\"ts\":" << time << ",\"args\":{\"id\":" << event.id;
+                        const auto enqueueTime = enqueueTimes.find(event.id);
+                        if (enqueueTime != enqueueTimes.end())
+                        {
+                            stream << ",\"queueDelayUs\":" << (time - getMicroseconds(enqueueTime->second));
+                        }
+                        stream << "}}";
+                        beginEvent("message", "f", threadIndex);
+                        stream << ",\"cat\":\"message\",\"bp\":\"e\",\"id\":" << event.id << ",\"ts\":" << time << "}";
+                        break;
+                    }
+                    case TraceEventType::End:
+                        beginEvent("message", "E", threadIndex);
+                        stream << ",\"cat\":\"message\",\"ts\":" << time << "}";
+                        break;
+                    case TraceEventType::Emit:
+                        beginEvent("emit", "i", threadIndex);
+                        stream << ",\"cat\":\"signal\",\"s\":\"t\",\"ts\":" << time << ",\"args\":{\"id\":" << event.id << ",\"signal\":\"" << event.object << "\"}}";
+                        for (const auto flow : emissionFlows[event.id])
+                        {
+                            beginEvent("signal", "s", threadIndex);
+                            stream << ",\"cat\":\"signal\",\"id\":" << flow << ",\"ts\":" << time << "}";
+                        }
+                        break;
+                    case TraceEventType::Deliver:
+                        beginEvent("deliver", "i", threadIndex);
+                        stream << ",\"cat\":\"signal\",\"s\":\"t\",\"ts\":" << time << ",\"args\":{\"id\":" << event.id << ",\"signal\":\"" << event.object << "\"}}";
+                        if (emissionFlows.find(event.id) != emissionFlows.end())
+                        {
+                            beginEvent("signal", "f", threadIndex);
+                            stream << ",\"cat\":\"signal\",\"bp\":\"e\",\"id\":" << ++flowCount << ",\"ts\":" << time << "}";
+                        }
+                        break;
+                }
+            }
+        }
+        stream << "\n]}\n";
+        stream.flags(flags);
+        stream.precision(precision);
+    }
+
+private:
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<TraceBuffer>> buffers;
+        std::uint32_t nextThreadIndex { 1 };
+        std::atomic<std::uint64_t> nextId { 1 };
+        /// @brief calibration point of the time stamps
+        const std::uint64_t baseTicks { getTraceTimestamp() };
+        const std::chrono::steady_clock::time_point baseTime { std::chrono::steady_clock::now() };
+    };
+
+    static inline Registry& getRegistry() noexcept
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    static inline TraceBuffer* getLocalBuffer() noexcept
+    {
+        thread_local std::shared_ptr<TraceBuffer> buffer { createBuffer() };
+        return buffer.get();
+    }
+
+    /// @return new buffer registered for the calling thread, nullptr if it could not be allocated (the thread is not traced)
+    static std::shared_ptr<TraceBuffer> createBuffer() noexcept
+    {
+        try
+        {
+            auto& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto buffer = std::make_shared<TraceBuffer>(registry.nextThreadIndex++, getThreadName());
+            registry.buffers.push_back(buffer);
+            return buffer;
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+
+    static std::string getThreadName()
+    {
+#if defined(__linux__) || defined(__APPLE__)
+        char name[64] {};
+        if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0)
+        {
+            return name;
+        }
+#endif
+        return {};
+    }
+
+    static void writeString(std::ostream& stream, const std::string& value)
+    {
+        stream << '"';
+        for (const auto c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                stream << '\\' << c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+            }
+            else
+            {
+                stream << c;
+            }
+        }
+        stream << '"';
+    }
+};
+
+}
+
+#endif /* Tracing_hpp */
@@ -0,0 +1,556 @@
+//
+//  WaitBackend.hpp
+//  Threads
+//
+//  Created by Gusts Kaksis on 14/10/2026.
+//  Copyright © 2026 Gusts Kaksis. All rights reserved.
+//
+
+#ifndef WaitBackend_hpp
+#define WaitBackend_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#if defined(__linux__)
+#   include <sys/epoll.h>
+#   include <sys/eventfd.h>
+#   include <unistd.h>
+#   define THREADS_HAS_EVENT_WAIT 1
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#   include <sys/types.h>
+#   include <sys/event.h>
+#   include <sys/time.h>
+#   include <unistd.h>
+#   define THREADS_HAS_EVENT_WAIT 1
+#endif
+
+namespace gusc::Threads
+{
+
+/// @brief what the run-loop of a thread blocks on while it has no messages
+enum class WaitBackendType
+{
+    /// @brief condition variable, file descriptors can not be watched
+    ConditionVariable,
+    /// @brief epoll and eventfd on Linux, kqueue on macOS and FreeBSD - file descriptors can be watched by the run-loop
+    Event
+};
+
+/// @brief readiness of a watched file descriptor (bit mask)
+enum class IoEvents : std::uint8_t
+{
+    None = 0,
+    Read = 1,
+    Write = 2,
+    /// @brief error or hang up, only reported (never needs to be requested)
+    Error = 4
+};
+
+inline constexpr IoEvents operator|(IoEvents a, IoEvents b) noexcept
+{
+    return static_cast<IoEvents>(static_cast<std::uint8_t>(a) | static_cast<std::uint8_t>(b));
+}
+
+inline constexpr IoEvents operator&(IoEvents a, IoEvents b) noexcept
+{
+    return static_cast<IoEvents>(static_cast<std::uint8_t>(a) & static_cast<std::uint8_t>(b));
+}
+
+/// @return true if any of the events are set
+inline constexpr bool getHasEvents(IoEvents events, IoEvents mask) noexcept
+{
+    return (events & mask) != IoEvents::None;
+}
+
+/// @brief interface of what a run-loop blocks on, with the bookkeeping of watched file descriptors
+/// @note file descriptor callbacks are collected while waiting (or polling) and called later by dispatch(), so that they are not called
+/// while the message mutex is held
+class WaitBackend
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using IoCallback = std::function<void(IoEvents)>;
+
+    WaitBackend() = default;
+    WaitBackend(const WaitBackend&) = delete;
+    WaitBackend& operator=(const WaitBackend&) = delete;
+    WaitBackend(WaitBackend&&) = delete;
+    WaitBackend& operator=(WaitBackend&&) = delete;
+    virtual ~WaitBackend() = default;
+
+    /// @brief block the run-loop until notify() is called, the deadline is reached or a watched file descriptor is ready
+    /// @param lock - lock of the message mutex, it's released while waiting
+    /// @param deadline - time to wake up at (no deadline - wait for a notification)
+    /// @note may return spuriously
+    virtual void wait(std::unique_lock<std::mutex>& lock, const std::optional<Clock::time_point>& deadline) = 0;
+
+    /// @brief wake up the waiting run-loop (a notification before the wait is not lost), can be called from any thread
+    virtual void notify() = 0;
+
+    /// @brief start watching a file descriptor, watching it again replaces the events and the callback
+    /// @param fd - file descriptor, it must stay open until it's unwatched
+    /// @param events - readiness to watch for (level-triggered)
+    /// @param callback - called on the run-loop with the events the descriptor is ready for
+    /// @throws std::runtime_error if the backend can not watch file descriptors or the descriptor can not be watched
+    void watch(int fd, IoEvents events, IoCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        const auto watchId = nextWatchId++;
+        // Bookkeeping is allocated before the descriptor is registered, so a failure leaves the previous watch as it was
+        const auto newWatch = watches.emplace(watchId, Watch{events, std::make_shared<const IoCallback>(std::move(callback))}).first;
+        try
+        {
+            const auto [existing, isNew] = watchIds.try_emplace(fd, watchId);
+            if (isNew)
+            {
+                try
+                {
+                    addWatch(fd, events, watchId);
+                }
+                catch (...)
+                {
+                    watchIds.erase(existing);
+                    throw;
+                }
+                watchCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                // Descriptor is modified in place, so it's never left unwatched
+                const auto previousId = existing->second;
+                modifyWatch(fd, watches[previousId].events, previousId, events, watchId);
+                existing->second = watchId;
+                watches.erase(previousId);
+            }
+        }
+        catch (...)
+        {
+            watches.erase(newWatch);
+            throw;
+        }
+    }
+
+    /// @brief stop watching a file descriptor, pending readiness of the descriptor is discarded
+    /// @return false if the descriptor was not watched
+    bool unwatch(int fd)
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        const auto it = watchIds.find(fd);
+        if (it == watchIds.end())
+        {
+            return false;
+        }
+        removeWatch(fd, watches[it->second].events);
+        watches.erase(it->second);
+        watchIds.erase(it);
+        watchCount.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// @return true if any file descriptors are watched
+    inline bool getIsWatching() const noexcept
+    {
+        return watchCount.load(std::memory_order_relaxed) > 0;
+    }
+
+    /// @brief collect the readiness of watched file descriptors without blocking
+    /// @warning must only be called from the run-loop
+    virtual void poll()
+    {}
+
+    /// @return true if wait() or poll() have found ready file descriptors that are not dispatched yet
+    /// @warning must only be called from the run-loop
+    inline bool getHasReadyEvents() const noexcept
+    {
+        return !readyEvents.empty();
+    }
+
+    /// @brief call the callbacks of the file descriptors found ready by the last wait() or poll()
+    /// @warning must only be called from the run-loop without holding the message mutex
+    void dispatch()
+    {
+        if (readyEvents.empty())
+        {
+            return;
+        }
+        std::swap(readyEvents, dispatchedEvents);
+        for (const auto& [watchId, events] : dispatchedEvents)
+        {
+            std::shared_ptr<const IoCallback> callback;
+            {
+                std::lock_guard<std::mutex> lock(watchMutex);
+                const auto it = watches.find(watchId);
+                if (it != watches.end())
+                {
+                    callback = it->second.callback;
+                }
+            }
+            // Watch IDs are never reused, so readiness of a descriptor that was unwatched (or watched again) is skipped
+            if (callback)
+            {
+                (*callback)(events);
+            }
+        }
+        dispatchedEvents.clear();
+    }
+
+protected:
+    /// @brief register a file descriptor with the system, readiness must be reported with addReadyEvents() using the watch ID
+    /// @warning called while holding the watch mutex
+    virtual void addWatch(int, IoEvents, std::uint64_t)
+    {
+        throw std::runtime_error("File descriptors can not be watched with this wait backend");
+    }
+
+    /// @brief change the events and the watch ID of a registered file descriptor
+    /// @note if this throws the descriptor must still be registered with the previous events and watch ID
+    /// @warning called while holding the watch mutex
+    virtual void modifyWatch(int, IoEvents, std::uint64_t, IoEvents, std::uint64_t)
+    {
+        throw std::runtime_error("File descriptors can not be watched with this wait backend");
+    }
+
+    /// @brief unregister a file descriptor from the system
+    /// @warning called while holding the watch mutex
+    virtual void removeWatch(int, IoEvents) noexcept
+    {}
+
+    /// @warning must only be called from the run-loop
+    inline void addReadyEvents(std::uint64_t watchId, IoEvents events)
+    {
+        readyEvents.emplace_back(watchId, events);
+    }
+
+    /// @return timeout in milliseconds until the deadline rounded up (-1 - no deadline)
+    static inline int getTimeout(const std::optional<Clock::time_point>& deadline) noexcept
+    {
+        if (!deadline)
+        {
+            return -1;
+        }
+        const auto timeNow = Clock::now();
+        if (*deadline <= timeNow)
+        {
+            return 0;
+        }
+        const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(*deadline - timeNow).count();
+        return static_cast<int>(std::min<std::chrono::milliseconds::rep>(timeout, std::numeric_limits<int>::max()));
+    }
+
+private:
+    struct Watch
+    {
+        IoEvents events { IoEvents::None };
+        std::shared_ptr<const IoCallback> callback;
+    };
+
+    std::mutex watchMutex;
+    std::unordered_map<std::uint64_t, Watch> watches;
+    std::unordered_map<int, std::uint64_t> watchIds;
+    /// @brief watch ID 0 is reserved for the backend's own wake up descriptor
+    std::uint64_t nextWatchId { 1 };
+    std::atomic<std::size_t> watchCount { 0 };
+    /// @brief accessed only by the run-loop
+    std::vector<std::pair<std::uint64_t, IoEvents>> readyEvents;
+    std::vector<std::pair<std::uint64_t, IoEvents>> dispatchedEvents;
+};
+
+/// @brief wait backend that blocks on a condition variable
+class ConditionWaitBackend : public WaitBackend
+{
+public:
+    void wait(std::unique_lock<std::mutex>& lock, const std::optional<Clock::time_point>& deadline) override
+    {
+        if (deadline)
+        {
+            condition.wait_until(lock, *deadline);
+        }
+        else
+        {
+            condition.wait(lock);
+        }
+    }
+
+    /// @warning must be called while holding the message mutex, otherwise the notification may be lost
+    void notify() override
+    {
+        condition.notify_one();
+    }
+
+private:
+    std::condition_variable condition;
+};
+
+#if defined(THREADS_HAS_EVENT_WAIT)
+
+/// @brief wait backend that blocks on epoll (Linux) or kqueue (macOS, FreeBSD), so that the run-loop can wait for it's messages and
+/// file descriptors with a single system call
+class EventWaitBackend : public WaitBackend
+{
+public:
+    /// @throws std::system_error if the system objects can not be created
+    EventWaitBackend()
+    {
+#if defined(__linux__)
+        pollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (pollFd < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "Failed to create epoll instance");
+        }
+        wakeUpFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (wakeUpFd < 0)
+        {
+            const auto error = errno;
+            close(pollFd);
+            throw std::system_error(error, std::system_category(), "Failed to create eventfd");
+        }
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.u64 = 0;
+        if (epoll_ctl(pollFd, EPOLL_CTL_ADD, wakeUpFd, &event) < 0)
+        {
+            const auto error = errno;
+            close(wakeUpFd);
+            close(pollFd);
+            throw std::system_error(error, std::system_category(), "Failed to watch eventfd");
+        }
+#else
+        pollFd = kqueue();
+        if (pollFd < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "Failed to create kqueue");
+        }
+        struct kevent event;
+        EV_SET(&event, 0, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+        if (kevent(pollFd, &event, 1, nullptr, 0, nullptr) < 0)
+        {
+            const auto error = errno;
+            close(pollFd);
+            throw std::system_error(error, std::system_category(), "Failed to add user event");
+        }
+#endif
+    }
+
+    ~EventWaitBackend() override
+    {
+#if defined(__linux__)
+        close(wakeUpFd);
+#endif
+        close(pollFd);
+    }
+
+    void wait(std::unique_lock<std::mutex>& lock, const std::optional<Clock::time_point>& deadline) override
+    {
+        const auto timeout = getTimeout(deadline);
+        lock.unlock();
+        collect(timeout);
+        lock.lock();
+    }
+
+    void notify() override
+    {
+#if defined(__linux__)
+        const std::uint64_t value { 1 };
+        // Counter overflow (EAGAIN) still leaves the descriptor readable, so the result can be ignored
+        [[maybe_unused]] const auto result = write(wakeUpFd, &value, sizeof(value));
+#else
+        struct kevent event;
+        EV_SET(&event, 0, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr);
+        kevent(pollFd, &event, 1, nullptr, 0, nullptr);
+#endif
+    }
+
+    void poll() override
+    {
+        collect(0);
+    }
+
+protected:
+    void addWatch(int fd, IoEvents events, std::uint64_t watchId) override
+    {
+#if defined(__linux__)
+        epoll_event event {};
+        event.events = (getHasEvents(events, IoEvents::Read) ? EPOLLIN : 0u) | (getHasEvents(events, IoEvents::Write) ? EPOLLOUT : 0u);
+        event.data.u64 = watchId;
+        if (epoll_ctl(pollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "Failed to watch file descriptor");
+        }
+#else
+        struct kevent changes[2];
+        int changeCount { 0 };
+        const auto userData = reinterpret_cast<void*>(static_cast<std::uintptr_t>(watchId));
+        if (getHasEvents(events, IoEvents::Read))
+        {
+            EV_SET(&changes[changeCount++], fd, EVFILT_READ, EV_ADD, 0, 0, userData);
+        }
+        if (getHasEvents(events, IoEvents::Write))
+        {
+            EV_SET(&changes[changeCount++], fd, EVFILT_WRITE, EV_ADD, 0, 0, userData);
+        }
+        if (changeCount && kevent(pollFd, changes, changeCount, nullptr, 0, nullptr) < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "Failed to watch file descriptor");
+        }
+#endif
+    }
+
+    void modifyWatch(int fd, [[maybe_unused]] IoEvents previousEvents, [[maybe_unused]] std::uint64_t previousWatchId, IoEvents events, std::uint64_t watchId) override
+    {
+#if defined(__linux__)
+        epoll_event event {};
+        event.events = (getHasEvents(events, IoEvents::Read) ? EPOLLIN : 0u) | (getHasEvents(events, IoEvents::Write) ? EPOLLOUT : 0u);
+        event.data.u64 = watchId;
+        if (epoll_ctl(pollFd, EPOLL_CTL_MOD, fd, &event) < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "Failed to watch file descriptor");
+        }
+#else
+        const auto userData = reinterpret_cast<void*>(static_cast<std::uintptr_t>(watchId));
+        for (const auto& [event, filter] : { std::make_pair(IoEvents::Read, EVFILT_READ), std::make_pair(IoEvents::Write, EVFILT_WRITE) })
+        {
+            if (!getHasEvents(events, event))
+            {
+                continue;
+            }
+            // EV_ADD of a registered filter replaces it's user data in place
+            struct kevent change;
+            EV_SET(&change, fd, filter, EV_ADD, 0, 0, userData);
+            if (kevent(pollFd, &change, 1, nullptr, 0, nullptr) < 0)
+            {
+                const auto error = errno;
+                // Put back the filters that have already been changed
+                if (event == IoEvents::Write && getHasEvents(events, IoEvents::Read))
+                {
+                    const auto previousData = reinterpret_cast<void*>(static_cast<std::uintptr_t>(previousWatchId));
+                    EV_SET(&change, fd, EVFILT_READ, getHasEvents(previousEvents, IoEvents::Read) ? EV_ADD : EV_DELETE, 0, 0, previousData);
+                    kevent(pollFd, &change, 1, nullptr, 0, nullptr);
+                }
+                throw std::system_error(error, std::system_category(), "Failed to watch file descriptor");
+            }
+        }
+        // Filters that are not watched any more are removed once the new ones are in place
+        removeWatch(fd, previousEvents & static_cast<IoEvents>(~static_cast<std::uint8_t>(events)));
+#endif
+    }
+
+    void removeWatch(int fd, [[maybe_unused]] IoEvents events) noexcept override
+    {
+        // Failures are ignored, the descriptor may have been closed already
+#if defined(__linux__)
+        epoll_ctl(pollFd, EPOLL_CTL_DEL, fd, nullptr);
+#else
+        struct kevent changes[2];
+        int changeCount { 0 };
+        if (getHasEvents(events, IoEvents::Read))
+        {
+            EV_SET(&changes[changeCount++], fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+        }
+        if (getHasEvents(events, IoEvents::Write))
+        {
+            EV_SET(&changes[changeCount++], fd, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+        }
+        if (changeCount)
+        {
+            kevent(pollFd, changes, changeCount, nullptr, 0, nullptr);
+        }
+#endif
+    }
+
+private:
+    static constexpr const int MaxEvents { 64 };
+
+    int pollFd { -1 };
+#if defined(__linux__)
+    int wakeUpFd { -1 };
+#endif
+
+    /// @brief wait for the system events and collect the readiness of the watched file descriptors
+    /// @param timeout - timeout in milliseconds (-1 - no timeout)
+    void collect(int timeout)
+    {
+#if defined(__linux__)
+        epoll_event events[MaxEvents];
+        const auto count = epoll_wait(pollFd, events, MaxEvents, timeout);
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& event = events[i];
+            if (event.data.u64 == 0)
+            {
+                std::uint64_t value { 0 };
+                [[maybe_unused]] const auto result = read(wakeUpFd, &value, sizeof(value));
+                continue;
+            }
+            auto ready = IoEvents::None;
+            if (event.events & EPOLLIN)
+            {
+                ready = ready | IoEvents::Read;
+            }
+            if (event.events & EPOLLOUT)
+            {
+                ready = ready | IoEvents::Write;
+            }
+            if (event.events & (EPOLLERR | EPOLLHUP))
+            {
+                ready = ready | IoEvents::Error;
+            }
+            addReadyEvents(event.data.u64, ready);
+        }
+#else
+        struct kevent events[MaxEvents];
+        struct timespec timeoutSpec { timeout / 1000, (timeout % 1000) * 1000000 };
+        const auto count = kevent(pollFd, nullptr, 0, events, MaxEvents, timeout < 0 ? nullptr : &timeoutSpec);
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& event = events[i];
+            if (event.filter == EVFILT_USER)
+            {
+                continue;
+            }
+            auto ready = (event.filter == EVFILT_READ) ? IoEvents::Read : IoEvents::Write;
+            if (event.flags & (EV_ERROR | EV_EOF))
+            {
+                ready = ready | IoEvents::Error;
+            }
+            addReadyEvents(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(event.udata)), ready);
+        }
+#endif
+    }
+};
+
+#endif
+
+/// @brief create a wait backend of the given type
+/// @throws std::runtime_error if the backend is not available on this platform or can not be created
+inline std::unique_ptr<WaitBackend> makeWaitBackend(WaitBackendType type)
+{
+    switch (type)
+    {
+        case WaitBackendType::Event:
+#if defined(THREADS_HAS_EVENT_WAIT)
+            return std::make_unique<EventWaitBackend>();
+#else
+            throw std::runtime_error("Event wait backend is not available on this platform");
+#endif
+        default:
+            return std::make_unique<ConditionWaitBackend>();
+    }
+}
+
+}
+
+#endif /* WaitBackend_hpp */